@@ -0,0 +1,612 @@
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "AsioContext.hpp"
+#include "Kernels.hpp"
+#include "SampleConvert.hpp"
+#include "SdkConvertSamples.hpp"
+
+// Measures sample conversion for a whole interface, both directions:
+//  - per-sample: a switch on the sample type for every sample, the way
+//    AsioVstPlug used to convert before converters were chosen per channel
+//  - per-buffer: the whole-buffer kernels of every CpuTier the CPU supports
+// then the output direction alone, per-sample truncation against the
+// dithered output stage of every tier, the input and output stages with
+// gain and metering as separate passes against the fused kernels, and the
+// mixing, gain and peak kernels of every tier.
+// With --validate it measures nothing and checks the converters instead:
+//  - FromFloat against the ASIO SDK converters, bit for bit
+//  - every tier against Scalar for all converter stages
+// exiting with 1 if anything differs
+
+using namespace GigOn::Helpers;
+
+const size_t DEFAULT_CHANNELS = 64;
+const size_t DEFAULT_BUFFER_SIZE = 256;
+const size_t DEFAULT_BLOCKS = 2000;
+
+const ASIOSampleType TYPES[] = {ASIOSTInt16LSB, ASIOSTInt16MSB, ASIOSTInt32LSB,
+                                ASIOSTInt32MSB};
+
+// Formats the dithered output stage is measured for
+const ASIOSampleType DITHER_TYPES[] = {ASIOSTInt16LSB, ASIOSTInt16MSB};
+
+const CpuTier TIERS[] = {CpuTier::Scalar, CpuTier::Sse2, CpuTier::Avx2,
+                         CpuTier::Avx512, CpuTier::Neon};
+
+const float GAIN = 0.5f;
+
+// Buffer sizes the converters are validated with, odd ones for the tails
+const size_t VALIDATE_SIZES[] = {1, 3, 7, 16, 33, 64, 257, 1000};
+
+template <typename T>
+T FromHost(T value, bool bigEndian) {
+  if (bigEndian == (std::endian::native == std::endian::big)) return value;
+
+  T swapped;
+  auto in = reinterpret_cast<const uint8_t*>(&value);
+  auto out = reinterpret_cast<uint8_t*>(&swapped);
+  for (size_t i = 0; i < sizeof(T); ++i) out[i] = in[sizeof(T) - 1 - i];
+
+  return swapped;
+}
+
+#define CASEGEN(asioType, hostType, bigEndian)                            \
+  case asioType:                                                          \
+    if (toFloat) {                                                        \
+      hostType val;                                                       \
+      std::memcpy(&val, sample, sizeof(val));                             \
+      *value = float(FromHost(val, bigEndian)) /                          \
+               std::numeric_limits<hostType>::max();                      \
+    } else {                                                              \
+      hostType val = *value * std::numeric_limits<hostType>::max();       \
+      val = FromHost(val, bigEndian);                                     \
+      std::memcpy(sample, &val, sizeof(val));                             \
+    }                                                                     \
+    return sizeof(hostType);
+
+#ifdef _MSC_VER
+__declspec(noinline)
+#else
+__attribute__((noinline))
+#endif
+size_t ConvertSample(void* sample, float* value, ASIOSampleType type,
+                     bool toFloat) {
+  switch (type) {
+    CASEGEN(ASIOSTInt16LSB, int16_t, false);
+    CASEGEN(ASIOSTInt16MSB, int16_t, true);
+    CASEGEN(ASIOSTInt32LSB, int32_t, false);
+    CASEGEN(ASIOSTInt32MSB, int32_t, true);
+    default:
+      return 0;
+  }
+}
+
+#undef CASEGEN
+
+struct BenchBuffers {
+  std::vector<uint8_t> Driver;
+  std::vector<float> Host;
+  size_t NumChannels;
+  size_t BufferSize;
+
+  BenchBuffers(size_t nChannels, size_t bufferSize)
+      : Driver(4 * nChannels * bufferSize),
+        Host(nChannels * bufferSize, 0.5f),
+        NumChannels{nChannels},
+        BufferSize{bufferSize} {}
+
+  uint8_t* GetDriver(size_t channel, size_t sampleSize) {
+    return &Driver[channel * BufferSize * sampleSize];
+  }
+
+  float* GetHost(size_t channel) { return &Host[channel * BufferSize]; }
+};
+
+template <typename FuncT>
+double Measure(FuncT&& func, size_t nBlocks, size_t nSamples) {
+  auto start = std::chrono::steady_clock::now();
+
+  for (size_t i = 0; i < nBlocks; ++i) func();
+
+  auto stop = std::chrono::steady_clock::now();
+  auto elapsed = std::chrono::duration<double, std::nano>(stop - start);
+
+  return elapsed.count() / nBlocks / nSamples;
+}
+
+void PerSample(BenchBuffers& buffers, ASIOSampleType type) {
+  size_t sampleSize = GetSampleSize(type);
+
+  for (size_t ch = 0; ch < buffers.NumChannels; ++ch) {
+    uint8_t* src = buffers.GetDriver(ch, sampleSize);
+    float* dst = buffers.GetHost(ch);
+
+    for (size_t i = 0; i < buffers.BufferSize; ++i)
+      src += ConvertSample(src, dst + i, type, true);
+  }
+
+  for (size_t ch = 0; ch < buffers.NumChannels; ++ch) {
+    float* src = buffers.GetHost(ch);
+    uint8_t* dst = buffers.GetDriver(ch, sampleSize);
+
+    for (size_t i = 0; i < buffers.BufferSize; ++i)
+      dst += ConvertSample(dst, src + i, type, false);
+  }
+}
+
+void PerBuffer(BenchBuffers& buffers, const SampleConverter& converter) {
+  for (size_t ch = 0; ch < buffers.NumChannels; ++ch)
+    converter.ToFloat(buffers.GetDriver(ch, converter.SampleSize),
+                      buffers.GetHost(ch), buffers.BufferSize);
+
+  for (size_t ch = 0; ch < buffers.NumChannels; ++ch)
+    converter.FromFloat(buffers.GetHost(ch),
+                        buffers.GetDriver(ch, converter.SampleSize),
+                        buffers.BufferSize);
+}
+
+void PerSampleOutput(BenchBuffers& buffers, ASIOSampleType type) {
+  size_t sampleSize = GetSampleSize(type);
+
+  for (size_t ch = 0; ch < buffers.NumChannels; ++ch) {
+    float* src = buffers.GetHost(ch);
+    uint8_t* dst = buffers.GetDriver(ch, sampleSize);
+
+    for (size_t i = 0; i < buffers.BufferSize; ++i)
+      dst += ConvertSample(dst, src + i, type, false);
+  }
+}
+
+void DitheredOutput(BenchBuffers& buffers, const SampleConverter& converter,
+                    std::vector<DitherState>& states) {
+  for (size_t ch = 0; ch < buffers.NumChannels; ++ch)
+    converter.FromFloatDither(buffers.GetHost(ch),
+                              buffers.GetDriver(ch, converter.SampleSize),
+                              buffers.BufferSize, states[ch]);
+}
+
+// Convert, gain and peak one kernel at a time, the output side through
+// a scratch buffer so the host buffers stay untouched
+void SeparateStages(BenchBuffers& buffers, const KernelTable& kernels,
+                    const SampleConverter& converter,
+                    std::vector<DitherState>& states, float* scratch) {
+  float peak = 0;
+
+  for (size_t ch = 0; ch < buffers.NumChannels; ++ch) {
+    float* host = buffers.GetHost(ch);
+
+    converter.ToFloat(buffers.GetDriver(ch, converter.SampleSize), host,
+                      buffers.BufferSize);
+    kernels.Gain(host, host, GAIN, buffers.BufferSize);
+    peak = kernels.Peak(host, buffers.BufferSize, peak);
+  }
+
+  for (size_t ch = 0; ch < buffers.NumChannels; ++ch) {
+    kernels.Gain(buffers.GetHost(ch), scratch, 1 / GAIN, buffers.BufferSize);
+    peak = kernels.Peak(scratch, buffers.BufferSize, peak);
+    converter.FromFloatDither(scratch,
+                              buffers.GetDriver(ch, converter.SampleSize),
+                              buffers.BufferSize, states[ch]);
+  }
+}
+
+void FusedStages(BenchBuffers& buffers, const SampleConverter& converter,
+                 std::vector<DitherState>& states) {
+  MeterState meter;
+
+  for (size_t ch = 0; ch < buffers.NumChannels; ++ch) {
+    GainRamp gain{GAIN};
+    ConvertInput(converter, buffers.GetDriver(ch, converter.SampleSize),
+                 buffers.GetHost(ch), buffers.BufferSize, gain, meter);
+  }
+
+  for (size_t ch = 0; ch < buffers.NumChannels; ++ch) {
+    GainRamp gain{1 / GAIN};
+    ConvertOutput(converter, buffers.GetHost(ch),
+                  buffers.GetDriver(ch, converter.SampleSize),
+                  buffers.BufferSize, gain, meter, states[ch]);
+  }
+}
+
+void MixGainPeak(BenchBuffers& buffers, const KernelTable& kernels) {
+  float* sum = buffers.GetHost(0);
+  float peak = 0;
+
+  for (size_t ch = 1; ch < buffers.NumChannels; ++ch) {
+    float* channel = buffers.GetHost(ch);
+
+    kernels.Gain(channel, channel, GAIN, buffers.BufferSize);
+    kernels.Mix(channel, sum, GAIN, buffers.BufferSize);
+    peak = kernels.Peak(channel, buffers.BufferSize, peak);
+  }
+
+  // Keep the values bounded between runs
+  kernels.Gain(sum, sum, peak > 0 ? 1 / peak : 0, buffers.BufferSize);
+}
+
+struct Validation {
+  std::mt19937 Random{1};
+  size_t Checks = 0;
+  size_t Mismatches = 0;
+
+  void Expect(bool equal, const std::string& what) {
+    ++Checks;
+    if (equal) return;
+
+    ++Mismatches;
+    std::cout << "Mismatch: " << what << std::endl;
+  }
+
+  // Uniform in [-limit, limit], with the edges of the range up front
+  std::vector<float> GetFloats(size_t size, float limit) {
+    std::uniform_real_distribution<float> dist{-limit, limit};
+    std::vector<float> values(size);
+    for (float& value : values) value = dist(Random);
+
+    const float edges[] = {1.f, -1.f, 0.f, -0.f, limit, -limit};
+    for (size_t i = 0; i < size && i < std::size(edges); ++i)
+      values[i] = edges[i];
+
+    return values;
+  }
+
+  std::vector<uint8_t> GetBytes(size_t size) {
+    std::vector<uint8_t> bytes(size);
+    for (uint8_t& byte : bytes) byte = uint8_t(Random());
+    return bytes;
+  }
+};
+
+template <typename T>
+bool SameBits(const T* lhs, const void* rhs, size_t size) {
+  return std::memcmp(lhs, rhs, size * sizeof(T)) == 0;
+}
+
+template <typename T>
+bool SameBits(const std::vector<T>& lhs, const std::vector<T>& rhs) {
+  return lhs.size() == rhs.size() &&
+         SameBits(lhs.data(), rhs.data(), lhs.size());
+}
+
+// NaN samples leave NaN sums, their sign depends on the operand order
+// of the instruction set, so any two NaNs match there
+bool SameBits(const MeterState& lhs, const MeterState& rhs) {
+  for (size_t i = 0; i < MeterState::Lanes; ++i)
+    if (!SameBits(&lhs.Squares[i], &rhs.Squares[i], 1) &&
+        !(std::isnan(lhs.Squares[i]) && std::isnan(rhs.Squares[i])))
+      return false;
+
+  return SameBits(&lhs.Peak, &rhs.Peak, 1) && lhs.Count == rhs.Count;
+}
+
+bool SameBits(const DitherState& lhs, const DitherState& rhs) {
+  return lhs.Mode == rhs.Mode &&
+         SameBits(lhs.Random, rhs.Random, DitherState::Lanes) &&
+         SameBits(&lhs.Last, &rhs.Last, 1);
+}
+
+std::vector<uint8_t> FromFloat(const SampleConverter& converter,
+                               const std::vector<float>& src) {
+  std::vector<uint8_t> dst(src.size() * converter.SampleSize);
+  converter.FromFloat(src.data(), dst.data(), src.size());
+  return dst;
+}
+
+std::string Describe(const char* stage, CpuTier tier, ASIOSampleType type,
+                     size_t size) {
+  return std::string{stage} + " " + CpuTierToStr(tier) + " " +
+         ASIOSampleTypeToStr(type) + " x" + std::to_string(size);
+}
+
+// FromFloat of a tier against the in-place float -> int converters of the
+// SDK, the other layouts derived with its shift and byte swap routines
+void ValidateSdk(Validation& check, const KernelTable& kernels,
+                 size_t size) {
+  auto converter = [&](ASIOSampleType type) -> const SampleConverter& {
+    return kernels.Converters[type];
+  };
+  auto describe = [&](const char* what, ASIOSampleType type) {
+    return Describe(what, kernels.Tier, type, size);
+  };
+
+  std::vector<float> src = check.GetFloats(size, 1.f);
+
+  std::vector<float> sdk = src;
+  SdkConvertSamples::Float32ToInt16InPlace(sdk.data(), size);
+  check.Expect(SameBits(FromFloat(converter(ASIOSTInt16LSB), src).data(),
+                        sdk.data(), 2 * size),
+               describe("float32toInt16inPlace", ASIOSTInt16LSB));
+
+  SdkConvertSamples::ReverseEndian(sdk.data(), 2, size);
+  check.Expect(SameBits(FromFloat(converter(ASIOSTInt16MSB), src).data(),
+                        sdk.data(), 2 * size),
+               describe("reverseEndian", ASIOSTInt16MSB));
+
+  sdk = src;
+  SdkConvertSamples::Float32ToInt32InPlace(sdk.data(), size);
+  check.Expect(SameBits(FromFloat(converter(ASIOSTInt32LSB), src).data(),
+                        sdk.data(), 4 * size),
+               describe("float32toInt32inPlace", ASIOSTInt32LSB));
+
+  SdkConvertSamples::ReverseEndian(sdk.data(), 4, size);
+  check.Expect(SameBits(FromFloat(converter(ASIOSTInt32MSB), src).data(),
+                        sdk.data(), 4 * size),
+               describe("reverseEndian", ASIOSTInt32MSB));
+
+  sdk = src;
+  SdkConvertSamples::ReverseEndian(sdk.data(), 4, size);
+  check.Expect(SameBits(FromFloat(converter(ASIOSTFloat32MSB), src).data(),
+                        sdk.data(), 4 * size),
+               describe("reverseEndian", ASIOSTFloat32MSB));
+
+  // Right-justified 16 and 24 bits, shifted up and packed
+  std::vector<uint8_t> lsb16 = FromFloat(converter(ASIOSTInt32LSB16), src);
+  SdkConvertSamples::Shift32(lsb16.data(), 16, 2, size);
+  check.Expect(SameBits(FromFloat(converter(ASIOSTInt16LSB), src).data(),
+                        lsb16.data(), 2 * size),
+               describe("shift32", ASIOSTInt32LSB16));
+
+  std::vector<uint8_t> int24 = FromFloat(converter(ASIOSTInt24LSB), src);
+  std::vector<uint8_t> lsb24 = FromFloat(converter(ASIOSTInt32LSB24), src);
+  SdkConvertSamples::Shift32(lsb24.data(), 8, 3, size);
+  check.Expect(SameBits(int24.data(), lsb24.data(), 3 * size),
+               describe("shift32", ASIOSTInt24LSB));
+
+  lsb24 = FromFloat(converter(ASIOSTInt32LSB24), src);
+  SdkConvertSamples::Shift32(lsb24.data(), 8, 4, size);
+  std::vector<uint8_t> int32 = lsb24;
+  SdkConvertSamples::Int32To24InPlace(int32.data(), size);
+  check.Expect(SameBits(int24.data(), int32.data(), 3 * size),
+               describe("int32to24inPlace", ASIOSTInt24LSB));
+
+  int32.assign(4 * size, 0);
+  std::memcpy(int32.data(), int24.data(), 3 * size);
+  SdkConvertSamples::Int24To32InPlace(int32.data(), size);
+  check.Expect(SameBits(lsb24, int32),
+               describe("int24to32inPlace", ASIOSTInt24LSB));
+
+  SdkConvertSamples::ReverseEndian(int24.data(), 3, size);
+  check.Expect(SameBits(FromFloat(converter(ASIOSTInt24MSB), src).data(),
+                        int24.data(), 3 * size),
+               describe("reverseEndian", ASIOSTInt24MSB));
+
+  const ASIOSampleType lsbTypes[] = {ASIOSTInt32LSB16, ASIOSTInt32LSB18,
+                                     ASIOSTInt32LSB20, ASIOSTInt32LSB24};
+  const ASIOSampleType msbTypes[] = {ASIOSTInt32MSB16, ASIOSTInt32MSB18,
+                                     ASIOSTInt32MSB20, ASIOSTInt32MSB24};
+
+  for (size_t i = 0; i < std::size(lsbTypes); ++i) {
+    std::vector<uint8_t> swapped = FromFloat(converter(lsbTypes[i]), src);
+    SdkConvertSamples::ReverseEndian(swapped.data(), 4, size);
+    check.Expect(SameBits(FromFloat(converter(msbTypes[i]), src), swapped),
+                 describe("reverseEndian", msbTypes[i]));
+  }
+}
+
+// Every stage of a tier's converter against the Scalar one, output
+// buffers, meters and dither states bit for bit, tails included
+void ValidateTier(Validation& check, CpuTier tier, ASIOSampleType type,
+                  size_t size) {
+  const SampleConverter& scalar =
+      GetKernels(CpuTier::Scalar)->Converters[type];
+  const SampleConverter& converter = GetKernels(tier)->Converters[type];
+  auto describe = [&](const char* stage) {
+    return Describe(stage, tier, type, size);
+  };
+
+  size_t bytes = size * converter.SampleSize;
+  std::vector<float> floats = check.GetFloats(size, 1.25f);
+  floats[0] = std::numeric_limits<float>::infinity();
+  floats[size - 1] = -std::numeric_limits<float>::infinity();
+
+  // Raw driver samples, NaNs and denormals of the float formats included
+  std::vector<uint8_t> raw = check.GetBytes(bytes);
+
+  // One spare element past the end catches writes beyond size
+  std::vector<float> expected(size + 1), actual(size + 1);
+  scalar.ToFloat(raw.data(), expected.data(), size);
+  converter.ToFloat(raw.data(), actual.data(), size);
+  check.Expect(SameBits(expected, actual), describe("ToFloat"));
+
+  std::vector<uint8_t> expectedRaw(bytes + 1), actualRaw(bytes + 1);
+  scalar.FromFloat(floats.data(), expectedRaw.data(), size);
+  converter.FromFloat(floats.data(), actualRaw.data(), size);
+  check.Expect(SameBits(expectedRaw, actualRaw), describe("FromFloat"));
+
+  for (DitherMode mode : {DitherMode::Tpdf, DitherMode::Shaped}) {
+    const char* name = mode == DitherMode::Tpdf ? "tpdf" : "shaped";
+
+    // Twice through, the second call going on from the first one's state
+    DitherState expectedDither{mode, 7}, actualDither{mode, 7};
+    for (int pass = 0; pass < 2; ++pass) {
+      scalar.FromFloatDither(floats.data(), expectedRaw.data(), size,
+                             expectedDither);
+      converter.FromFloatDither(floats.data(), actualRaw.data(), size,
+                                actualDither);
+      check.Expect(SameBits(expectedRaw, actualRaw) &&
+                       SameBits(expectedDither, actualDither),
+                   describe("FromFloatDither") + " " + name);
+    }
+
+    MeterState expectedMeter, actualMeter;
+    scalar.FromFloatGain(floats.data(), expectedRaw.data(), size, GAIN,
+                         -GAIN / size, expectedMeter, expectedDither);
+    converter.FromFloatGain(floats.data(), actualRaw.data(), size, GAIN,
+                            -GAIN / size, actualMeter, actualDither);
+    check.Expect(SameBits(expectedRaw, actualRaw) &&
+                     SameBits(expectedMeter, actualMeter) &&
+                     SameBits(expectedDither, actualDither),
+                 describe("FromFloatGain") + " " + name);
+  }
+
+  MeterState expectedMeter, actualMeter;
+  scalar.ToFloatGain(raw.data(), expected.data(), size, GAIN, GAIN / size,
+                     expectedMeter);
+  converter.ToFloatGain(raw.data(), actual.data(), size, GAIN, GAIN / size,
+                        actualMeter);
+  check.Expect(
+      SameBits(expected, actual) && SameBits(expectedMeter, actualMeter),
+      describe("ToFloatGain"));
+}
+
+int Validate() {
+  Validation check;
+
+  for (CpuTier tier : TIERS) {
+    const KernelTable* kernels = GetKernels(tier);
+    if (!kernels) continue;
+
+    for (size_t size : VALIDATE_SIZES) {
+      ValidateSdk(check, *kernels, size);
+
+      for (int type = 0; type < ASIOSTLastEntry; ++type)
+        if (kernels->Converters[type].ToFloat)
+          ValidateTier(check, tier, ASIOSampleType(type), size);
+    }
+
+    std::cout << CpuTierToStr(tier) << " validated" << std::endl;
+  }
+
+  std::cout << check.Checks << " checks, " << check.Mismatches
+            << " mismatches" << std::endl;
+
+  return check.Mismatches ? 1 : 0;
+}
+
+void PrintUsageAndExit(const char* reason) {
+  std::cout << "Incorrect " << reason << std::endl;
+  std::cout << "Usage:   ./ConvertBench [<CHANNELS> <BUFFER_SIZE> <BLOCKS>]"
+            << std::endl;
+  std::cout << "         ./ConvertBench --validate" << std::endl;
+  std::cout << "Example: ./ConvertBench 64 256 2000";
+  exit(1);
+}
+
+int main(int argc, char* argv[]) try {
+  if (argc == 2 && std::string{argv[1]} == "--validate") return Validate();
+  if (argc != 1 && argc != 4) PrintUsageAndExit("argument count");
+
+  size_t nChannels = argc == 4 ? std::stoul(argv[1]) : DEFAULT_CHANNELS;
+  size_t bufferSize = argc == 4 ? std::stoul(argv[2]) : DEFAULT_BUFFER_SIZE;
+  size_t nBlocks = argc == 4 ? std::stoul(argv[3]) : DEFAULT_BLOCKS;
+
+  BenchBuffers buffers{nChannels, bufferSize};
+  size_t nSamples = 2 * nChannels * bufferSize;
+
+  std::cout << nChannels << " in / " << nChannels << " out, " << bufferSize
+            << " samples, " << nBlocks << " blocks" << std::endl;
+
+  std::cout << "Bound kernels: " << CpuTierToStr(GetKernels().Tier)
+            << " (override with " << CpuTierVariable << ")" << std::endl;
+
+  for (ASIOSampleType type : TYPES) {
+    // Warm up caches
+    PerBuffer(buffers, *GetSampleConverter(type));
+
+    double perSample =
+        Measure([&] { PerSample(buffers, type); }, nBlocks, nSamples);
+
+    std::cout << ASIOSampleTypeToStr(type) << ": per-sample " << perSample
+              << " ns";
+
+    for (CpuTier tier : TIERS) {
+      const KernelTable* kernels = GetKernels(tier);
+      if (!kernels) continue;
+
+      const SampleConverter& converter = kernels->Converters[type];
+      double perBuffer =
+          Measure([&] { PerBuffer(buffers, converter); }, nBlocks, nSamples);
+
+      std::cout << ", " << CpuTierToStr(tier) << " " << perBuffer << " ns (x"
+                << perSample / perBuffer << ")";
+    }
+
+    std::cout << std::endl;
+  }
+
+  for (ASIOSampleType type : DITHER_TYPES) {
+    double perSample = Measure([&] { PerSampleOutput(buffers, type); },
+                               nBlocks, nSamples / 2);
+
+    std::cout << ASIOSampleTypeToStr(type) << " out: truncation " << perSample
+              << " ns";
+
+    for (DitherMode mode : {DitherMode::Tpdf, DitherMode::Shaped}) {
+      std::cout << (mode == DitherMode::Tpdf ? ", tpdf" : ", shaped");
+
+      for (CpuTier tier : TIERS) {
+        const KernelTable* kernels = GetKernels(tier);
+        if (!kernels) continue;
+
+        std::vector<DitherState> states;
+        for (size_t ch = 0; ch < nChannels; ++ch)
+          states.emplace_back(mode, uint32_t(ch + 1));
+
+        const SampleConverter& converter = kernels->Converters[type];
+        double dithered =
+            Measure([&] { DitheredOutput(buffers, converter, states); },
+                    nBlocks, nSamples / 2);
+
+        std::cout << " " << CpuTierToStr(tier) << " " << dithered << " ns (x"
+                  << perSample / dithered << ")";
+      }
+    }
+
+    std::cout << std::endl;
+  }
+
+  std::vector<float> scratch(bufferSize);
+
+  for (ASIOSampleType type : TYPES) {
+    std::cout << ASIOSampleTypeToStr(type) << " gain + meter:";
+
+    for (CpuTier tier : TIERS) {
+      const KernelTable* kernels = GetKernels(tier);
+      if (!kernels) continue;
+
+      std::vector<DitherState> states;
+      for (size_t ch = 0; ch < nChannels; ++ch)
+        states.emplace_back(DitherMode::Tpdf, uint32_t(ch + 1));
+
+      const SampleConverter& converter = kernels->Converters[type];
+      double separate = Measure(
+          [&] {
+            SeparateStages(buffers, *kernels, converter, states,
+                           scratch.data());
+          },
+          nBlocks, nSamples);
+      double fused = Measure([&] { FusedStages(buffers, converter, states); },
+                             nBlocks, nSamples);
+
+      std::cout << " " << CpuTierToStr(tier) << " " << separate << " -> "
+                << fused << " ns (x" << separate / fused << ")";
+    }
+
+    std::cout << std::endl;
+  }
+
+  std::cout << "Gain + mix + peak:";
+
+  for (CpuTier tier : TIERS) {
+    const KernelTable* kernels = GetKernels(tier);
+    if (!kernels) continue;
+
+    double elapsed = Measure([&] { MixGainPeak(buffers, *kernels); }, nBlocks,
+                             nSamples / 2);
+    std::cout << " " << CpuTierToStr(tier) << " " << elapsed << " ns";
+  }
+
+  std::cout << std::endl;
+
+} catch (std::exception& e) {
+  std::cout << "Got exception: " << e.what() << std::endl;
+  return 1;
+}
@@ -0,0 +1,152 @@
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "AsioContext.hpp"
+
+// Measures the cost of a single buffer switch for the three ways
+// AsioContext can reach a processor:
+//  - IProcessor through AsioChannelAdapter (one virtual call per channel)
+//  - IBlockProcessor (one virtual call per block)
+//  - SetStaticHandlers<ProcT>() (no virtual calls at all)
+// The driver is not involved: blocks point to host-allocated buffers and
+// the dispatch callbacks are invoked directly
+
+using namespace GigOn;
+using namespace GigOn::Helpers;
+
+using Block = AsioContext::Block;
+using ChannelBuffer = AsioContext::ChannelBuffer;
+
+const size_t DEFAULT_CHANNELS = 64;
+const size_t DEFAULT_BUFFER_SIZE = 64;
+const size_t DEFAULT_SWITCHES = 200000;
+
+const float GAIN = 0.5f;
+
+void Amplify(const void* src, void* dst, size_t size) {
+  auto in = reinterpret_cast<const float*>(src);
+  auto out = reinterpret_cast<float*>(dst);
+
+  for (size_t i = 0; i < size; ++i) out[i] = in[i] * GAIN;
+}
+
+struct ChannelGain final : public AsioContext::IProcessor {
+  std::vector<void*> Inputs;
+  size_t BufferSize = 0;
+
+  void Configure(size_t bufSize, size_t nInputs, size_t nOutputs) override {
+    BufferSize = bufSize;
+    Inputs.assign(nInputs, nullptr);
+  }
+
+  void ProcessInput(long channel, void* buffer,
+                    ASIOSampleType) noexcept override {
+    Inputs[channel] = buffer;
+  }
+
+  void ProcessOutput(long channel, void* buffer,
+                     ASIOSampleType) noexcept override {
+    Amplify(Inputs[channel], buffer, BufferSize);
+  }
+};
+
+struct BlockGain final : public AsioContext::IBlockProcessor {
+  void Configure(size_t, size_t, size_t) override {}
+
+  void ProcessBlock(const Block& block) noexcept override {
+    for (size_t i = 0; i < block.Outputs.size(); ++i)
+      Amplify(block.Inputs[i].Buffer, block.Outputs[i].Buffer,
+              block.BufferSize);
+  }
+};
+
+struct BenchBuffers {
+  std::vector<float> Storage;
+  AlignedVector<ChannelBuffer> Channels[2];
+  Block Blocks[2];
+
+  BenchBuffers(size_t nChannels, size_t bufferSize)
+      : Storage(4 * nChannels * bufferSize, 1.f) {
+    for (long index = 0; index < 2; ++index) {
+      auto& channels = Channels[index];
+
+      for (size_t i = 0; i < 2 * nChannels; ++i) {
+        float* buf = &Storage[(2 * i + index) * bufferSize];
+        long channel = i < nChannels ? i : i - nChannels;
+        channels.push_back({buf, nullptr, ASIOSTFloat32LSB, channel});
+      }
+
+      auto all = std::span<const ChannelBuffer>{channels};
+
+      Blocks[index].Index = index;
+      Blocks[index].BufferSize = bufferSize;
+      Blocks[index].Inputs = all.first(nChannels);
+      Blocks[index].Outputs = all.subspan(nChannels);
+    }
+  }
+};
+
+template <typename ProcT>
+double RunSwitches(ProcT* processor, BenchBuffers& buffers,
+                   size_t nSwitches) {
+  using DispatchT = AsioContext::Dispatch<ProcT>;
+  DispatchT::Bind(processor, buffers.Blocks, nullptr, false, nullptr);
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (size_t i = 0; i < nSwitches; ++i)
+    DispatchT::BufferSwitch(i % 2, ASIOTrue);
+
+  auto stop = std::chrono::steady_clock::now();
+  auto elapsed = std::chrono::duration<double, std::nano>(stop - start);
+
+  return elapsed.count() / nSwitches;
+}
+
+void Report(const char* name, double nsPerSwitch, double baseline) {
+  std::cout << name << nsPerSwitch << " ns/switch (x" << baseline / nsPerSwitch
+            << ")" << std::endl;
+}
+
+void PrintUsageAndExit(const char* reason) {
+  std::cout << "Incorrect " << reason << std::endl;
+  std::cout << "Usage:   ./DispatchBench [<CHANNELS> <BUFFER_SIZE> <SWITCHES>]"
+            << std::endl;
+  std::cout << "Example: ./DispatchBench 64 64 200000";
+  exit(1);
+}
+
+int main(int argc, char* argv[]) try {
+  if (argc != 1 && argc != 4) PrintUsageAndExit("argument count");
+
+  size_t nChannels = argc == 4 ? std::stoul(argv[1]) : DEFAULT_CHANNELS;
+  size_t bufferSize = argc == 4 ? std::stoul(argv[2]) : DEFAULT_BUFFER_SIZE;
+  size_t nSwitches = argc == 4 ? std::stoul(argv[3]) : DEFAULT_SWITCHES;
+
+  BenchBuffers buffers{nChannels, bufferSize};
+
+  auto channelProc = AsioChannelAdapter::Create(std::make_unique<ChannelGain>());
+  channelProc->Configure(bufferSize, nChannels, nChannels);
+
+  auto blockProc = std::make_unique<BlockGain>();
+  AsioContext::IBlockProcessor* virtualProc = blockProc.get();
+
+  std::cout << nChannels << " in / " << nChannels << " out, " << bufferSize
+            << " samples, " << nSwitches << " switches" << std::endl;
+
+  // Warm up caches and branch predictors
+  RunSwitches(blockProc.get(), buffers, nSwitches / 10);
+
+  double perChannel = RunSwitches(channelProc.get(), buffers, nSwitches);
+  double perBlock = RunSwitches(virtualProc, buffers, nSwitches);
+  double staticBlock = RunSwitches(blockProc.get(), buffers, nSwitches);
+
+  Report("IProcessor:         ", perChannel, perChannel);
+  Report("IBlockProcessor:    ", perBlock, perChannel);
+  Report("SetStaticHandlers:  ", staticBlock, perChannel);
+
+} catch (std::exception& e) {
+  std::cout << "Got exception: " << e.what() << std::endl;
+}
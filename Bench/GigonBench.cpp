@@ -0,0 +1,693 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "AsioContext.hpp"
+#include "Kernels.hpp"
+#include "SampleConvert.hpp"
+#include "SimAsioDriver.hpp"
+#include "VstEventQueue.hpp"
+#include "VstProcessBuffer.hpp"
+
+#ifdef _WIN32
+#include "Vst2Effect.hpp"
+#endif
+
+// Microbenchmark suite over the whole processing path:
+//  - convert:  every sample converter, both directions, to float and
+//              to double
+//  - buffer:   VstProcessBuffer setup from the heap or an arena,
+//              rebinding, and a multichannel gain over packed and
+//              padded channel layouts
+//  - events:   VstEventQueue, one per channel, pushing and collecting
+//              EVENT_RATE notes per second
+//  - dispatch: a buffer switch through AsioContext on SimAsioDriver,
+//              the driver is not started, switches are invoked directly
+//  - plugin:   Vst2Effect::Process() on the SDK sample plugins, in single
+//              and, where supported, double precision, and in single
+//              precision with EVENT_RATE notes per instance (Windows).
+//              The buffer padding is set with --padding
+// every case over BLOCK_SIZES x CHANNEL_COUNTS.
+//
+// Results can be written to JSON and compared with a previous run:
+//   ./gigon-bench --json base.json
+//   ./gigon-bench --baseline base.json --threshold 10
+// Comparison exits with 1 if any case got slower than the threshold
+
+using namespace GigOn;
+using namespace GigOn::Helpers;
+
+const size_t BLOCK_SIZES[] = {16, 64, 256, 1024, 4096};
+const size_t CHANNEL_COUNTS[] = {1, 2, 8, 32, 128};
+
+const CpuTier TIERS[] = {CpuTier::Scalar, CpuTier::Sse2, CpuTier::Avx2,
+                         CpuTier::Avx512, CpuTier::Neon};
+
+// Every case is timed in REPEATS batches of at least BATCH_TIME. The
+// fastest batch counts: interruptions only ever add time
+const size_t REPEATS = 7;
+const std::chrono::microseconds BATCH_TIME{1000};
+const std::chrono::microseconds QUICK_BATCH_TIME{200};
+
+const double DEFAULT_THRESHOLD = 10;  // %
+
+const double SAMPLE_RATE = 48000;
+const float TONE_AMPLITUDE = 0.5f;
+
+const double EVENT_RATE = 10000;  // per second and queue or instance
+
+struct Options {
+  std::string JsonPath;
+  std::string BaselinePath;
+  std::string Filter;
+  double Threshold = DEFAULT_THRESHOLD;
+  bool AllTiers = false;
+  std::chrono::microseconds BatchTime = BATCH_TIME;
+  std::vector<std::string> Plugins;
+  size_t Padding = VstProcessBuffer::DefaultPadding;
+};
+
+struct Result {
+  std::string Name;
+  size_t Samples = 0;
+  double NsPerCall = 0;
+
+  double GetNsPerSample() const { return NsPerCall / Samples; }
+};
+
+class Runner {
+  const Options& Opts;
+  std::vector<Result> Results;
+
+ public:
+  Runner(const Options& options) : Opts{options} {}
+
+  // Cases not matching --filter are skipped before any setup
+  bool Wants(const std::string& name) const {
+    return name.find(Opts.Filter) != std::string::npos;
+  }
+
+  // Times func, which handles samples samples per call
+  template <typename FuncT>
+  void Run(const std::string& name, size_t samples, FuncT&& func) {
+    using Clock = std::chrono::steady_clock;
+
+    // Grow the batch until it lasts long enough, this also warms up
+    size_t calls = 1;
+    for (;;) {
+      auto start = Clock::now();
+      for (size_t i = 0; i < calls; ++i) func();
+      if (Clock::now() - start >= Opts.BatchTime) break;
+      calls *= 2;
+    }
+
+    double best = std::numeric_limits<double>::max();
+    for (size_t r = 0; r < REPEATS; ++r) {
+      auto start = Clock::now();
+      for (size_t i = 0; i < calls; ++i) func();
+      auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() -
+                                                              start);
+      best = std::min(best, elapsed.count() / calls);
+    }
+
+    Result& result = Results.emplace_back(Result{name, samples, best});
+
+    std::cout << std::left << std::setw(52) << name << std::right
+              << std::setw(14) << std::fixed << std::setprecision(1)
+              << result.NsPerCall << " ns" << std::setw(10)
+              << std::setprecision(3) << result.GetNsPerSample()
+              << " ns/sample" << std::defaultfloat << std::endl;
+  }
+
+  const std::vector<Result>& GetResults() const { return Results; }
+};
+
+std::string MakeName(std::initializer_list<std::string> parts, size_t nChannels,
+                     size_t blockSize) {
+  std::string name;
+  for (const auto& part : parts) name += part + "/";
+
+  return name + std::to_string(nChannels) + "x" + std::to_string(blockSize);
+}
+
+template <typename T>
+void FillTone(T* dst, size_t size, size_t channel) {
+  for (size_t i = 0; i < size; ++i)
+    dst[i] = TONE_AMPLITUDE * std::sin(0.01f * (channel + 1) * i);
+}
+
+// Alternating note-ons and note-offs at EVENT_RATE, the ones in
+// [begin, begin + frames). next is the index of the next note
+template <typename PushT>
+void PushNotes(size_t& next, int64_t begin, size_t frames, PushT&& push) {
+  for (;; ++next) {
+    auto position = int64_t(next * SAMPLE_RATE / EVENT_RATE);
+    if (position >= begin + int64_t(frames)) break;
+
+    uint8_t status = next % 2 ? 0x80 : 0x90;
+    uint8_t note = 48 + next / 2 % 24;
+    push(MidiEvent{position, {status, note, 100}});
+  }
+}
+
+/*** convert ***/
+
+void ConvertCase(Runner& runner, const std::string& prefix,
+                 const SampleConverter& converter, size_t nChannels,
+                 size_t blockSize) {
+  std::string in = MakeName({prefix, "in"}, nChannels, blockSize);
+  std::string out = MakeName({prefix, "out"}, nChannels, blockSize);
+  std::string in64 = MakeName({prefix, "in64"}, nChannels, blockSize);
+  std::string out64 = MakeName({prefix, "out64"}, nChannels, blockSize);
+
+  if (!runner.Wants(in) && !runner.Wants(out) && !runner.Wants(in64) &&
+      !runner.Wants(out64))
+    return;
+
+  size_t samples = nChannels * blockSize;
+  size_t stride = blockSize * converter.SampleSize;
+
+  std::vector<float> host(samples);
+  std::vector<double> host64(samples);
+  std::vector<uint8_t> driver(samples * converter.SampleSize);
+
+  for (size_t ch = 0; ch < nChannels; ++ch)
+    FillTone(&host[ch * blockSize], blockSize, ch);
+
+  // Valid driver samples, so float formats see no NaNs
+  converter.FromFloat(host.data(), driver.data(), samples);
+
+  if (runner.Wants(in)) {
+    runner.Run(in, samples, [&] {
+      for (size_t ch = 0; ch < nChannels; ++ch)
+        converter.ToFloat(&driver[ch * stride], &host[ch * blockSize],
+                          blockSize);
+    });
+  }
+
+  if (runner.Wants(out)) {
+    runner.Run(out, samples, [&] {
+      for (size_t ch = 0; ch < nChannels; ++ch)
+        converter.FromFloat(&host[ch * blockSize], &driver[ch * stride],
+                            blockSize);
+    });
+  }
+
+  if (runner.Wants(in64)) {
+    runner.Run(in64, samples, [&] {
+      for (size_t ch = 0; ch < nChannels; ++ch)
+        converter.ToDouble(&driver[ch * stride], &host64[ch * blockSize],
+                           blockSize);
+    });
+  }
+
+  if (runner.Wants(out64)) {
+    converter.ToDouble(driver.data(), host64.data(), samples);
+
+    runner.Run(out64, samples, [&] {
+      for (size_t ch = 0; ch < nChannels; ++ch)
+        converter.FromDouble(&host64[ch * blockSize], &driver[ch * stride],
+                             blockSize);
+    });
+  }
+}
+
+// Only the bound tier unless --all-tiers is given
+void ConvertSuite(Runner& runner, const Options& options) {
+  for (CpuTier tier : TIERS) {
+    const KernelTable* kernels = GetKernels(tier);
+    if (!kernels) continue;
+    if (!options.AllTiers && tier != GetKernels().Tier) continue;
+
+    for (long type = 0; type < ASIOSTLastEntry; ++type) {
+      const SampleConverter& converter = kernels->Converters[type];
+      if (!converter.ToFloat) continue;
+
+      std::string prefix = std::string{"convert/"} + CpuTierToStr(tier) +
+                           "/" + ASIOSampleTypeToStr(type);
+
+      for (size_t nChannels : CHANNEL_COUNTS)
+        for (size_t blockSize : BLOCK_SIZES)
+          ConvertCase(runner, prefix, converter, nChannels, blockSize);
+    }
+  }
+}
+
+/*** buffer ***/
+
+// Multichannel processing the way a matrix or surround plugin does it:
+// one cache line of every channel at a time. With channels exactly a
+// power of two apart all those lines compete for the same cache sets
+void GainCase(Runner& runner, const std::string& name, size_t nChannels,
+              size_t blockSize, size_t padding) {
+  const size_t line = CacheLineSize / sizeof(float);
+  const float gain = 0.7f;
+
+  VstProcessBuffer input{blockSize, nChannels, padding};
+  VstProcessBuffer output{blockSize, nChannels, padding};
+
+  for (size_t ch = 0; ch < nChannels; ++ch)
+    FillTone(input.GetBufferByChannel(ch), blockSize, ch);
+
+  const float* const* in = input.GetVstBuffers();
+  float* const* out = output.GetVstBuffers();
+
+  runner.Run(name, nChannels * blockSize, [&] {
+    for (size_t begin = 0; begin < blockSize; begin += line) {
+      size_t end = std::min(begin + line, blockSize);
+
+      for (size_t ch = 0; ch < nChannels; ++ch)
+        for (size_t i = begin; i < end; ++i) out[ch][i] = in[ch][i] * gain;
+    }
+  });
+}
+
+void BufferSuite(Runner& runner) {
+  for (size_t nChannels : CHANNEL_COUNTS) {
+    for (size_t blockSize : BLOCK_SIZES) {
+      size_t samples = nChannels * blockSize;
+
+      std::string create =
+          MakeName({"buffer", "create"}, nChannels, blockSize);
+      if (runner.Wants(create))
+        runner.Run(create, samples,
+                   [&] { VstProcessBuffer buffer{blockSize, nChannels}; });
+
+      // Reconfiguration out of a warm arena, as AsioVstPlug does it
+      std::string arena = MakeName({"buffer", "arena"}, nChannels, blockSize);
+      if (runner.Wants(arena)) {
+        BufferArena pool;
+        runner.Run(arena, samples, [&] {
+          pool.Reset();
+          VstProcessBuffer buffer{pool, blockSize, nChannels};
+        });
+      }
+
+      // The zero-copy path of AsioVstPlug: point every channel at
+      // external memory, then back at the owned storage
+      std::string bind = MakeName({"buffer", "bind"}, nChannels, blockSize);
+      if (runner.Wants(bind)) {
+        VstProcessBuffer buffer{blockSize, nChannels};
+        std::vector<float> external(samples);
+
+        runner.Run(bind, samples, [&] {
+          for (size_t ch = 0; ch < nChannels; ++ch)
+            buffer.SetBufferByChannel(ch, &external[ch * blockSize]);
+          for (size_t ch = 0; ch < nChannels; ++ch)
+            buffer.ResetBufferByChannel(ch);
+        });
+      }
+
+      // Channels back to back against the default padding
+      std::string packed =
+          MakeName({"buffer", "gain", "packed"}, nChannels, blockSize);
+      if (runner.Wants(packed))
+        GainCase(runner, packed, nChannels, blockSize, 0);
+
+      std::string padded =
+          MakeName({"buffer", "gain", "padded"}, nChannels, blockSize);
+      if (runner.Wants(padded))
+        GainCase(runner, padded, nChannels, blockSize,
+                 VstProcessBuffer::DefaultPadding);
+    }
+  }
+}
+
+/*** events ***/
+
+void EventSuite(Runner& runner) {
+  for (size_t nChannels : CHANNEL_COUNTS) {
+    for (size_t blockSize : BLOCK_SIZES) {
+      std::string name = MakeName({"events", "notes"}, nChannels, blockSize);
+      if (!runner.Wants(name)) continue;
+
+      std::vector<std::unique_ptr<VstEventQueue>> queues;
+      for (size_t ch = 0; ch < nChannels; ++ch)
+        queues.push_back(std::make_unique<VstEventQueue>());
+
+      std::vector<size_t> next(nChannels);
+
+      runner.Run(name, nChannels * blockSize, [&] {
+        for (size_t ch = 0; ch < nChannels; ++ch) {
+          auto& queue = *queues[ch];
+
+          PushNotes(next[ch], queue.GetPosition(), blockSize,
+                    [&](const MidiEvent& event) {
+                      if (!queue.Push(event))
+                        throw std::runtime_error("Event queue overflow");
+                    });
+          queue.Collect(blockSize);
+        }
+      });
+    }
+  }
+}
+
+/*** dispatch ***/
+
+// Echoes every input to the output of the same position
+struct EchoProcessor final {
+  std::vector<float> Scratch;
+
+  void Configure(size_t bufSize, size_t, size_t) { Scratch.assign(bufSize, 0); }
+
+  void ProcessBlock(const AsioContext::Block& block) noexcept {
+    for (size_t i = 0; i < block.Outputs.size(); ++i) {
+      const auto& input = block.Inputs[i];
+      const auto& output = block.Outputs[i];
+
+      input.Converter->ToFloat(input.Buffer, Scratch.data(), block.BufferSize);
+      output.Converter->FromFloat(Scratch.data(), output.Buffer,
+                                  block.BufferSize);
+    }
+  }
+};
+
+void DispatchSuite(Runner& runner) {
+  auto& asio = AsioContext::Get();
+
+  for (size_t nChannels : CHANNEL_COUNTS) {
+    SimAsioDriver::Config config;
+    config.NumInputs = nChannels;
+    config.NumOutputs = nChannels;
+    config.Paced = false;
+
+    bool loaded = false;
+
+    for (size_t blockSize : BLOCK_SIZES) {
+      std::string name = MakeName({"dispatch", "echo"}, nChannels, blockSize);
+      if (!runner.Wants(name)) continue;
+
+      if (!loaded) {
+        asio.LoadDriver(std::make_unique<SimAsioDriver>(config));
+        asio.InitDriver();
+        loaded = true;
+      }
+
+      std::vector<AsioContext::ChannelId> channels(nChannels);
+      for (size_t ch = 0; ch < nChannels; ++ch) channels[ch] = ch;
+
+      asio.SetStaticHandlers(std::make_unique<EchoProcessor>(),
+                             AsioHandlerMock::Create([](auto) {}));
+      asio.CreateBuffers(channels, channels, blockSize);
+
+      // Same entry point the driver calls, with the context's tables
+      long index = 0;
+      runner.Run(name, 2 * nChannels * blockSize, [&] {
+        AsioContext::Dispatch<EchoProcessor>::BufferSwitch(index, ASIOTrue);
+        index ^= 1;
+      });
+
+      asio.DisposeBuffers();
+    }
+
+    if (loaded) {
+      asio.DeInitDriver();
+      asio.UnloadDriver();
+    }
+  }
+
+  if (AsioContext::TakeRtErrors())
+    throw std::runtime_error("Dispatch raised real-time errors");
+}
+
+/*** plugin ***/
+
+#ifdef _WIN32
+
+std::string GetPluginName(const std::string& path) {
+  size_t begin = path.find_last_of("/\\");
+  begin = begin == std::string::npos ? 0 : begin + 1;
+
+  return path.substr(begin, path.rfind('.') - begin);
+}
+
+// Channels are covered by as many plugin instances as it takes,
+// each processing its own buffers. T is the sample type. With midi
+// every instance gets EVENT_RATE notes ahead of its process calls
+template <typename T>
+void PluginCase(Runner& runner, const DllLoader& dll, const std::string& name,
+                size_t nChannels, size_t blockSize, size_t padding,
+                bool midi = false) {
+  constexpr auto precision = std::is_same_v<T, double>
+                                 ? Vst2Effect::Precision::Double
+                                 : Vst2Effect::Precision::Single;
+
+  std::vector<Vst2Effect> effects;
+  std::vector<BasicVstProcessBuffer<T>> inputs, outputs;
+
+  size_t covered = 0;
+  while (covered < nChannels) {
+    auto& effect = effects.emplace_back(dll);
+    auto info = effect.GetInfo();
+
+    effect.Configure(SAMPLE_RATE, blockSize, precision);
+    effect.Start();
+
+    auto& input = inputs.emplace_back(blockSize, info.NumInputs, padding);
+    outputs.emplace_back(blockSize, info.NumOutputs, padding);
+
+    for (size_t ch = 0; ch < info.NumInputs; ++ch)
+      FillTone(input.GetBufferByChannel(ch), blockSize, ch);
+
+    covered += std::max<size_t>(info.NumOutputs, 1);
+  }
+
+  std::vector<size_t> next(effects.size());
+
+  runner.Run(name, covered * blockSize, [&] {
+    for (size_t i = 0; i < effects.size(); ++i) {
+      auto& effect = effects[i];
+
+      if (midi)
+        PushNotes(next[i], effect.GetSamplePosition(), blockSize,
+                  [&](const MidiEvent& event) {
+                    if (!effect.SendMidi(event))
+                      throw std::runtime_error("Event queue overflow");
+                  });
+
+      effect.Process(inputs[i], outputs[i]);
+    }
+  });
+
+  for (auto& effect : effects) effect.Stop();
+}
+
+void PluginSuite(Runner& runner, const Options& options) {
+  for (const auto& path : options.Plugins) {
+    DllLoader dll{path};
+    std::string plugin = GetPluginName(path);
+    bool canDouble = Vst2Effect{dll}.GetInfo().CanProcessDouble;
+
+    for (size_t nChannels : CHANNEL_COUNTS) {
+      for (size_t blockSize : BLOCK_SIZES) {
+        std::string name =
+            MakeName({"plugin", plugin, "f32"}, nChannels, blockSize);
+        if (runner.Wants(name))
+          PluginCase<float>(runner, dll, name, nChannels, blockSize,
+                            options.Padding);
+
+        name = MakeName({"plugin", plugin, "f64"}, nChannels, blockSize);
+        if (canDouble && runner.Wants(name))
+          PluginCase<double>(runner, dll, name, nChannels, blockSize,
+                             options.Padding);
+
+        name = MakeName({"plugin", plugin, "midi"}, nChannels, blockSize);
+        if (runner.Wants(name))
+          PluginCase<float>(runner, dll, name, nChannels, blockSize,
+                            options.Padding, true);
+      }
+    }
+  }
+}
+
+#endif
+
+/*** report ***/
+
+void WriteJson(const std::string& path, const std::vector<Result>& results) {
+  std::ofstream out{path};
+  if (!out) throw std::runtime_error("Failed to open " + path);
+
+  out << std::setprecision(6);
+  out << "{\n";
+  out << "  \"tier\": \"" << CpuTierToStr(GetKernels().Tier) << "\",\n";
+  out << "  \"results\": [\n";
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Result& result = results[i];
+
+    out << "    {\"name\": \"" << result.Name
+        << "\", \"samples\": " << result.Samples
+        << ", \"ns_per_call\": " << result.NsPerCall
+        << ", \"ns_per_sample\": " << result.GetNsPerSample() << "}"
+        << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+
+  out << "  ]\n";
+  out << "}\n";
+}
+
+// Reads ns_per_call by name from a file written by WriteJson().
+// Only that layout is understood, one result per line
+std::map<std::string, double> ReadJson(const std::string& path) {
+  std::ifstream in{path};
+  if (!in) throw std::runtime_error("Failed to open " + path);
+
+  const std::string nameKey = "\"name\": \"";
+  const std::string timeKey = "\"ns_per_call\": ";
+
+  std::map<std::string, double> results;
+
+  for (std::string line; std::getline(in, line);) {
+    size_t name = line.find(nameKey);
+    size_t time = line.find(timeKey);
+    if (name == std::string::npos || time == std::string::npos) continue;
+
+    name += nameKey.size();
+    size_t nameEnd = line.find('"', name);
+    if (nameEnd == std::string::npos) continue;
+
+    results[line.substr(name, nameEnd - name)] =
+        std::strtod(line.c_str() + time + timeKey.size(), nullptr);
+  }
+
+  return results;
+}
+
+// Prints the cases that moved by more than the threshold,
+// returns the number of regressions
+size_t Compare(const std::vector<Result>& results,
+               const std::map<std::string, double>& baseline,
+               double threshold) {
+  size_t regressions = 0, improvements = 0, missing = 0;
+
+  std::cout << std::endl << "Against baseline, threshold " << threshold
+            << "%:" << std::endl;
+
+  for (const Result& result : results) {
+    auto it = baseline.find(result.Name);
+    if (it == baseline.end() || it->second <= 0) {
+      ++missing;
+      continue;
+    }
+
+    double change = (result.NsPerCall / it->second - 1) * 100;
+    if (std::fabs(change) <= threshold) continue;
+
+    bool slower = change > 0;
+    slower ? ++regressions : ++improvements;
+
+    std::cout << (slower ? "  REGRESSION " : "  improved   ") << std::left
+              << std::setw(52) << result.Name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(12) << it->second
+              << " -> " << std::setw(12) << result.NsPerCall << " ns ("
+              << std::showpos << change << std::noshowpos << "%)"
+              << std::defaultfloat << std::endl;
+  }
+
+  std::cout << regressions << " regressions, " << improvements
+            << " improvements, " << missing << " not in the baseline"
+            << std::endl;
+
+  return regressions;
+}
+
+void PrintUsageAndExit(const char* reason) {
+  std::cout << "Incorrect " << reason << std::endl;
+  std::cout << "Usage:   ./gigon-bench [--json <FILE>] [--baseline <FILE>] "
+               "[--threshold <PERCENT>] [--filter <TEXT>] [--all-tiers] "
+               "[--quick] [--padding <BYTES>] [--plugin <DLL>]..."
+            << std::endl;
+  std::cout << "Example: ./gigon-bench --filter dispatch --json new.json "
+               "--baseline old.json";
+  exit(2);
+}
+
+Options ParseOptions(int argc, char* argv[]) {
+  Options options;
+
+#ifdef GIGON_BENCH_PLUGINS
+  // Comma separated, the SDK samples built along with the benchmark
+  std::stringstream plugins{GIGON_BENCH_PLUGINS};
+  for (std::string path; std::getline(plugins, path, ',');)
+    options.Plugins.push_back(path);
+  bool defaultPlugins = true;
+#endif
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+
+    if (arg == "--all-tiers") {
+      options.AllTiers = true;
+    } else if (arg == "--quick") {
+      options.BatchTime = QUICK_BATCH_TIME;
+    } else if (!hasValue) {
+      PrintUsageAndExit("arguments");
+    } else if (arg == "--json") {
+      options.JsonPath = argv[++i];
+    } else if (arg == "--baseline") {
+      options.BaselinePath = argv[++i];
+    } else if (arg == "--threshold") {
+      options.Threshold = std::stod(argv[++i]);
+    } else if (arg == "--filter") {
+      options.Filter = argv[++i];
+    } else if (arg == "--padding") {
+      options.Padding = std::stoul(argv[++i]);
+    } else if (arg == "--plugin") {
+#ifdef GIGON_BENCH_PLUGINS
+      if (defaultPlugins) options.Plugins.clear();
+      defaultPlugins = false;
+#endif
+      options.Plugins.push_back(argv[++i]);
+    } else {
+      PrintUsageAndExit("arguments");
+    }
+  }
+
+  return options;
+}
+
+int main(int argc, char* argv[]) try {
+  Options options = ParseOptions(argc, argv);
+
+  // Fail before measuring anything
+  std::map<std::string, double> baseline;
+  if (!options.BaselinePath.empty()) baseline = ReadJson(options.BaselinePath);
+
+  std::cout << "Bound kernels: " << CpuTierToStr(GetKernels().Tier)
+            << " (override with " << CpuTierVariable << ")" << std::endl;
+
+  Runner runner{options};
+
+  ConvertSuite(runner, options);
+  BufferSuite(runner);
+  EventSuite(runner);
+  DispatchSuite(runner);
+#ifdef _WIN32
+  PluginSuite(runner, options);
+#endif
+
+  if (!options.JsonPath.empty())
+    WriteJson(options.JsonPath, runner.GetResults());
+
+  if (!options.BaselinePath.empty() &&
+      Compare(runner.GetResults(), baseline, options.Threshold) > 0)
+    return 1;
+
+} catch (std::exception& e) {
+  std::cout << "Got exception: " << e.what() << std::endl;
+  return 2;
+}
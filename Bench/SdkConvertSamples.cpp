@@ -0,0 +1,50 @@
+#include <climits>
+#include <cmath>
+
+// The SDK converters take long for 32-bit samples. Off Windows they are
+// built with the little-endian BEOS profile of ginclude.h, and on LP64
+// with long narrowed to int
+#ifndef _WIN32
+#define BEOS 1
+#endif
+
+#if LONG_MAX > INT_MAX
+#define long int
+#endif
+
+#include "ASIOConvertSamples.cpp"
+
+#undef long
+
+#include "SdkConvertSamples.hpp"
+
+namespace SdkConvertSamples {
+
+static ASIOConvertSamples Sdk;
+
+void Float32ToInt16InPlace(float* buffer, size_t frames) {
+  Sdk.float32toInt16inPlace(buffer, frames);
+}
+
+void Float32ToInt32InPlace(float* buffer, size_t frames) {
+  Sdk.float32toInt32inPlace(buffer, frames);
+}
+
+void Shift32(void* buffer, int shiftAmount, int targetByteWidth,
+             size_t frames) {
+  Sdk.shift32(buffer, shiftAmount, targetByteWidth, false, frames);
+}
+
+void ReverseEndian(void* buffer, int byteWidth, size_t frames) {
+  Sdk.reverseEndian(buffer, byteWidth, frames);
+}
+
+void Int32To24InPlace(void* buffer, size_t frames) {
+  Sdk.int32to24inPlace(buffer, frames);
+}
+
+void Int24To32InPlace(void* buffer, size_t frames) {
+  Sdk.int24to32inPlace(buffer, frames);
+}
+
+}  // namespace SdkConvertSamples
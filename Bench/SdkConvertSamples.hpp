@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+
+// In-place converters of the ASIO SDK (Lib/asiosdk/host), the reference
+// ConvertBench --validate checks the converters against
+namespace SdkConvertSamples {
+
+void Float32ToInt16InPlace(float* buffer, size_t frames);
+void Float32ToInt32InPlace(float* buffer, size_t frames);
+
+// Shifts the 4-byte samples left by shiftAmount bits and keeps their
+// upper targetByteWidth bytes, packed
+void Shift32(void* buffer, int shiftAmount, int targetByteWidth,
+             size_t frames);
+void ReverseEndian(void* buffer, int byteWidth, size_t frames);
+
+void Int32To24InPlace(void* buffer, size_t frames);
+void Int24To32InPlace(void* buffer, size_t frames);
+
+}  // namespace SdkConvertSamples
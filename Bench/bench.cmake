@@ -0,0 +1,44 @@
+add_executable(DispatchBench Bench/DispatchBench.cpp)
+target_link_libraries(DispatchBench PUBLIC AsioContext)
+
+# --validate checks the converters against the SDK ones
+add_executable(ConvertBench Bench/ConvertBench.cpp Bench/SdkConvertSamples.cpp)
+target_link_libraries(ConvertBench PUBLIC AsioContext)
+set_source_files_properties(Bench/SdkConvertSamples.cpp PROPERTIES
+    INCLUDE_DIRECTORIES ${CMAKE_CURRENT_SOURCE_DIR}/Lib/asiosdk/host)
+
+add_executable(gigon-bench Bench/GigonBench.cpp)
+target_link_libraries(gigon-bench PUBLIC AsioContext VstEventQueue
+                                          VstProcessBuffer)
+
+# SDK sample plugins for the plugin suite, passed to gigon-bench
+# as its default --plugin list
+if(WIN32)
+  set(VST2_SDK_DIR ${CMAKE_CURRENT_SOURCE_DIR}/Lib/vstsdk2.4)
+  set(VST2_SAMPLES_DIR ${VST2_SDK_DIR}/public.sdk/samples/vst2.x)
+  set(VST2_PLUGIN_SOURCES
+      ${VST2_SDK_DIR}/public.sdk/source/vst2.x/audioeffect.cpp
+      ${VST2_SDK_DIR}/public.sdk/source/vst2.x/audioeffectx.cpp
+      ${VST2_SDK_DIR}/public.sdk/source/vst2.x/vstplugmain.cpp
+      ${VST2_SAMPLES_DIR}/win/vstplug.def)
+
+  add_library(again SHARED ${VST2_SAMPLES_DIR}/again/source/again.cpp
+                           ${VST2_PLUGIN_SOURCES})
+  add_library(adelay SHARED ${VST2_SAMPLES_DIR}/adelay/adelay.cpp
+                            ${VST2_SAMPLES_DIR}/adelay/adelaymain.cpp
+                            ${VST2_PLUGIN_SOURCES})
+  add_library(vstxsynth SHARED
+              ${VST2_SAMPLES_DIR}/vstxsynth/source/vstxsynth.cpp
+              ${VST2_SAMPLES_DIR}/vstxsynth/source/vstxsynthproc.cpp
+              ${VST2_PLUGIN_SOURCES})
+
+  foreach(plugin again adelay vstxsynth)
+    target_include_directories(${plugin} PRIVATE ${VST2_SDK_DIR})
+    target_link_libraries(${plugin} PRIVATE AEffectX)
+  endforeach()
+
+  target_link_libraries(gigon-bench PUBLIC Vst2Effect)
+  add_dependencies(gigon-bench again adelay vstxsynth)
+  target_compile_definitions(gigon-bench PRIVATE
+      GIGON_BENCH_PLUGINS="$<TARGET_FILE:again>,$<TARGET_FILE:adelay>,$<TARGET_FILE:vstxsynth>")
+endif()
@@ -1,12 +1,22 @@
+#include <atomic>
 #include <cassert>
-#include <limits>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
 
 #include "AsioContext.hpp"
+#include "SimAsioDriver.hpp"
 
 #undef max  // I hate Windows
 
 const unsigned short SCALE_SIZE = 50;
-const DWORD UPDATE_PERIOD_MS = 100;
+const std::chrono::milliseconds UPDATE_PERIOD{100};
+
+const float IMPULSE_AMPLITUDE = 0.9;
+const float IMPULSE_THRESHOLD = 0.5;
+const int64_t IMPULSE_PERIOD = 24000;
+const int64_t IMPULSE_TIMEOUT = 96000;
 
 using namespace GigOn;
 using namespace GigOn::Helpers;
@@ -35,69 +45,153 @@ void DisplayValue(float value) {
   std::cout << "|" << std::flush;
 }
 
+// Round-trip measurement: emits an impulse every IMPULSE_PERIOD samples
+// and waits for it to come back. The output has to be wired to the input
+struct ImpulseMeter {
+  std::vector<float> Scratch;
+  int64_t Clock = 0;
+  int64_t EmittedAt = -1;
+  int64_t NextImpulse = 0;
+
+  // Last measured round trip in samples, -1 if none yet
+  std::atomic<int64_t> Measured = -1;
+
+  ImpulseMeter(size_t bufferSize) : Scratch(bufferSize) {}
+
+  void Process(const AsioContext::Block& block) noexcept {
+    const auto& input = block.Inputs[0];
+    const auto& output = block.Outputs[0];
+
+    assert(input.Converter);
+    assert(output.Converter);
+
+    // Prefer the driver's clock, so dropped blocks don't skew the result
+    if (block.Time.IsValid(kSamplePositionValid))
+      Clock = block.Time.SamplePosition;
+
+    size_t size = block.BufferSize;
+    input.Converter->ToFloat(input.Buffer, Scratch.data(), size);
+
+    if (EmittedAt >= 0) {
+      for (size_t i = 0; i < size; ++i) {
+        if (std::fabs(Scratch[i]) < IMPULSE_THRESHOLD) continue;
+
+        Measured = Clock + i - EmittedAt;
+        EmittedAt = -1;
+        break;
+      }
+
+      if (EmittedAt >= 0 && Clock - EmittedAt > IMPULSE_TIMEOUT)
+        EmittedAt = -1;
+    }
+
+    std::fill(Scratch.begin(), Scratch.end(), 0.f);
+
+    if (EmittedAt < 0 && Clock >= NextImpulse) {
+      Scratch[0] = IMPULSE_AMPLITUDE;
+      EmittedAt = Clock;
+      NextImpulse = Clock + IMPULSE_PERIOD;
+    }
+
+    output.Converter->FromFloat(Scratch.data(), output.Buffer, size);
+    Clock += size;
+  }
+};
+
 void PrintUsageAndExit(const char* reason) {
   std::cout << "Incorrect " << reason << std::endl;
   std::cout << "Usage:   ./Echo <DRIVER_NAME> <BUFFER_SIZE> <IN_CHANNEL> "
-               "<OUT_CHANNEL>"
+               "<OUT_CHANNEL> [measure]"
             << std::endl;
-  std::cout << "Example: ./Echo \"Focusrite USB ASIO\" 64 1 1";
+  std::cout << "Example: ./Echo \"Focusrite USB ASIO\" 64 1 1" << std::endl;
+  std::cout << "With \"measure\", the output has to be looped back to the "
+               "input. It is done internally for the simulator";
   exit(1);
 }
 
 int main(int argc, char* argv[]) try {
-  if (argc != 5) PrintUsageAndExit("argument count");
+  if (argc != 5 && argc != 6) PrintUsageAndExit("argument count");
+  if (argc == 6 && std::string{argv[5]} != "measure")
+    PrintUsageAndExit("mode");
 
   std::string driverName = argv[1];
   size_t bufferSize = std::stoul(argv[2]);
   size_t inChannel = std::stoul(argv[3]);
   size_t outChannel = std::stoul(argv[4]);
+  bool measure = argc == 6;
+
+  // Input level of the last block, RMS
+  std::atomic<float> level = 0;
+
+  std::vector<float> scratch(bufferSize);
+  GainRamp inputGain, outputGain;
+  MeterState inputMeter, outputMeter;
+  DitherState dither;
+
+  // Blocks lost between two switches, detected by the sample position
+  size_t dropped = 0;
+  int64_t expected = -1;
+
+  // Inputs are visible before any output is written,
+  // so the block can be echoed in one go
+  auto blockCb = [&](const AsioContext::Block& block) {
+    if (block.Time.IsValid(kSamplePositionValid)) {
+      int64_t position = block.Time.SamplePosition;
+      if (expected >= 0 && position > expected)
+        dropped += (position - expected) / bufferSize;
+      expected = position + bufferSize;
+    }
 
-  float average = 0;
-
-  // We guarantee that input callback will
-  // be called before output callbacks
-  void* inputBuffer = nullptr;
-
-  auto inputCb = [bufferSize, &average, &inputBuffer](
-                     long channel, void* buffer, ASIOSampleType stype) {
-    assert(stype == ASIOSTInt32LSB);
-    assert(buffer);
+    assert(block.Inputs.size() == 1);
+    assert(block.Outputs.size() == 1);
 
-    auto samplePtr = reinterpret_cast<int32_t*>(buffer);
+    const auto& input = block.Inputs[0];
+    const auto& output = block.Outputs[0];
 
-    average = 0;
+    assert(input.Converter);
+    assert(output.Converter);
 
-    for (int i = 0; i < bufferSize; ++i, ++samplePtr) {
-      int32_t max = std::numeric_limits<int32_t>::max();
-      int32_t sample = *samplePtr;  // le32toh(*samplePtr);
-      average += float(sample) / max;
-    }
+    // Metered while converting, no extra pass over the samples
+    ConvertInput(*input.Converter, input.Buffer, scratch.data(), bufferSize,
+                 inputGain, inputMeter);
+    ConvertOutput(*output.Converter, scratch.data(), output.Buffer, bufferSize,
+                  outputGain, outputMeter, dither);
 
-    average /= bufferSize;
+    level = inputMeter.GetRms();
+    inputMeter.Reset();
+  };
 
-    inputBuffer = buffer;
+  ImpulseMeter meter{bufferSize};
+  auto measureCb = [&meter](const AsioContext::Block& block) {
+    meter.Process(block);
   };
 
-  auto outputCb = [bufferSize, &inputBuffer](long channel, void* buffer,
-                                             ASIOSampleType stype) {
-    assert(stype == ASIOSTInt32LSB);
-    assert(inputBuffer);
-    assert(buffer);
+  std::atomic<bool> latenciesChanged = false;
 
-    memcpy(buffer, inputBuffer, 4 * bufferSize);
+  auto eventCb = [&latenciesChanged](AsioContext::DriverEvent event) {
+    if (event == AsioContext::DriverEvent::LatenciesChanged)
+      latenciesChanged = true;
   };
-  auto eventCb = [](GigOn::AsioContext::DriverEvent event) -> void {};
   auto confCb = [](size_t, size_t, size_t) {};
 
   auto& asio = GigOn::AsioContext::Get();
 
   std::cout << "Loading driver \"" << driverName << "\"..." << std::endl;
-  asio.LoadDriver(driverName);
+
+  if (measure && driverName == SimAsioDriver::Name) {
+    SimAsioDriver::Config config;
+    config.Loopback = true;
+    asio.LoadDriver(std::make_unique<SimAsioDriver>(config));
+  } else {
+    asio.LoadDriver(driverName);
+  }
+
   asio.InitDriver();
 
   std::cout << "Creating buffer..." << std::endl;
 
-  auto processor = AsioProcessorMock::Create(inputCb, outputCb, confCb);
+  auto processor = measure ? AsioBlockProcessorMock::Create(measureCb, confCb)
+                           : AsioBlockProcessorMock::Create(blockCb, confCb);
   auto handler = AsioHandlerMock::Create(eventCb);
 
   asio.SetHandlers(std::move(processor), std::move(handler));
@@ -106,11 +200,35 @@ int main(int argc, char* argv[]) try {
   std::cout << "Starting..." << std::endl;
   asio.Start();
 
+  DumpLatencyInfo(std::cout, asio.GetLatencyInfo());
+
+  while (measure) {
+    if (latenciesChanged.exchange(false))
+      DumpLatencyInfo(std::cout, asio.GetLatencyInfo());
+
+    auto latency = asio.GetLatencyInfo();
+    size_t reported = latency.GetRoundTrip();
+    int64_t measured = meter.Measured;
+
+    std::cout << "\rReported: " << reported << " samples ("
+              << latency.ToMicroseconds(reported) << " us), measured: ";
+
+    if (measured < 0)
+      std::cout << "none";
+    else
+      std::cout << measured << " samples ("
+                << latency.ToMicroseconds(measured) << " us)";
+
+    std::cout << "    " << std::flush;
+    std::this_thread::sleep_for(UPDATE_PERIOD);
+  }
+
   std::cout << "Monitoring the channel:" << std::endl;
 
   while (true) {
-    DisplayValue(average);
-    Sleep(UPDATE_PERIOD_MS);
+    DisplayValue(level);
+    std::cout << " dropped: " << dropped << std::flush;
+    std::this_thread::sleep_for(UPDATE_PERIOD);
   }
 
   asio.Stop();
@@ -29,6 +29,9 @@ int main(int argc, char* argv[]) try {
   std::cout << TAB "Product: " << info.Product << std::endl;
   std::cout << TAB "Inputs:  " << info.NumInputs << std::endl;
   std::cout << TAB "Outputs: " << info.NumOutputs << std::endl;
+  std::cout << TAB "Double:  " << (info.CanProcessDouble ? "yes" : "no")
+            << std::endl;
+  std::cout << TAB "Synth:   " << (info.IsSynth ? "yes" : "no") << std::endl;
 
   effect.Configure(48000.f, 64);
   effect.Start();
@@ -0,0 +1,98 @@
+#include <cassert>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+#include "AsioContext.hpp"
+#include "Kernels.hpp"
+#include "OfflineAsioDriver.hpp"
+
+using namespace GigOn;
+using namespace GigOn::Helpers;
+
+void PrintUsageAndExit(const char* reason) {
+  std::cout << "Incorrect " << reason << std::endl;
+  std::cout << "Usage:   ./Render <INPUT_WAV> <OUTPUT_WAV> <BUFFER_SIZE> "
+               "<GAIN>"
+            << std::endl;
+  std::cout << "Example: ./Render in.wav out.wav 512 0.5";
+  exit(1);
+}
+
+int main(int argc, char* argv[]) try {
+  if (argc != 5) PrintUsageAndExit("argument count");
+
+  std::string inputPath = argv[1];
+  std::string outputPath = argv[2];
+  size_t bufferSize = std::stoul(argv[3]);
+  float gain = std::stof(argv[4]);
+
+  // Output file mirrors the input channel layout
+  size_t nChannels = WavReader{inputPath}.GetChannels();
+
+  OfflineAsioDriver::Config config;
+  config.InputFiles = {inputPath};
+  config.OutputFiles = {{outputPath, nChannels}};
+
+  auto driver = std::make_unique<OfflineAsioDriver>(config);
+  auto& offline = *driver;
+
+  std::vector<float> scratch(bufferSize);
+
+  const auto& kernels = GetKernels();
+
+  auto blockCb = [&scratch, &kernels, gain](const AsioContext::Block& block) {
+    assert(block.Inputs.size() == block.Outputs.size());
+
+    for (size_t i = 0; i < block.Inputs.size(); ++i) {
+      const auto& input = block.Inputs[i];
+      const auto& output = block.Outputs[i];
+
+      input.Converter->ToFloat(input.Buffer, scratch.data(), block.BufferSize);
+      kernels.Gain(scratch.data(), scratch.data(), gain, block.BufferSize);
+      output.Converter->FromFloat(scratch.data(), output.Buffer,
+                                  block.BufferSize);
+    }
+  };
+
+  auto eventCb = [](AsioContext::DriverEvent event) -> void {};
+  auto confCb = [](size_t, size_t, size_t) {};
+
+  auto& asio = AsioContext::Get();
+
+  asio.LoadDriver(std::move(driver));
+  asio.InitDriver();
+
+  auto processor = AsioBlockProcessorMock::Create(blockCb, confCb);
+  auto handler = AsioHandlerMock::Create(eventCb);
+
+  std::vector<AsioContext::ChannelId> channels(nChannels);
+  std::iota(channels.begin(), channels.end(), 0);
+
+  asio.SetHandlers(std::move(processor), std::move(handler));
+  asio.CreateBuffers(channels, channels, bufferSize);
+
+  std::cout << "Rendering \"" << inputPath << "\" with "
+            << CpuTierToStr(kernels.Tier) << " kernels..." << std::endl;
+  asio.Start();
+
+  auto stats = offline.Wait();
+
+  ASIOSampleRate sampleRate = 0;
+  offline.GetSampleRate(&sampleRate);
+
+  std::cout << "Rendered " << stats.RenderedFrames << " frames in "
+            << stats.Elapsed.count() / 1e6 << " ms ("
+            << stats.GetRealtimeFactor(sampleRate) << "x realtime)"
+            << std::endl;
+
+  DumpXrunInfo(std::cout, asio.GetXrunInfo());
+
+  asio.Stop();
+  asio.DisposeBuffers();
+  asio.DeInitDriver();
+  asio.UnloadDriver();
+
+} catch (std::exception& e) {
+  std::cout << "Got exception: " << e.what() << std::endl;
+}
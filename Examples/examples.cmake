@@ -4,5 +4,10 @@ target_link_libraries(Echo PUBLIC AsioContext)
 add_executable(Explorer Examples/DriverExplorer.cpp)
 target_link_libraries(Explorer PUBLIC AsioContext)
 
-add_executable(LoadPlugin Examples/LoadPlugin.cpp)
-target_link_libraries(LoadPlugin PUBLIC Vst2Effect)
\ No newline at end of file
+add_executable(Render Examples/Render.cpp)
+target_link_libraries(Render PUBLIC AsioContext OfflineAsioDriver)
+
+if(WIN32)
+  add_executable(LoadPlugin Examples/LoadPlugin.cpp)
+  target_link_libraries(LoadPlugin PUBLIC Vst2Effect)
+endif()
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace GigOn {
+namespace Helpers {
+
+constexpr size_t CacheLineSize = 64;
+
+// Allocator that places the whole storage on an Alignment boundary.
+// Element layout is untouched, only the first element is aligned
+template <typename T, size_t Alignment = CacheLineSize>
+struct AlignedAllocator {
+  static_assert(Alignment >= alignof(T), "Alignment is too small for T");
+
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() = default;
+
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+  T* allocate(size_t n) {
+    void* ptr = ::operator new(n * sizeof(T), std::align_val_t{Alignment});
+    return static_cast<T*>(ptr);
+  }
+
+  void deallocate(T* ptr, size_t) {
+    ::operator delete(ptr, std::align_val_t{Alignment});
+  }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U, Alignment>&) const {
+    return true;
+  }
+};
+
+template <typename T, size_t Alignment = CacheLineSize>
+using AlignedVector = std::vector<T, AlignedAllocator<T, Alignment>>;
+
+}  // namespace Helpers
+}  // namespace GigOn
@@ -1,21 +1,45 @@
+#pragma once
+
 // asiosys needs to be included first
 // clang-format off
 #include "asiosys.h"
 #include "asio.h"
-#include "asiodrivers.h"
 // clang-format on
 
+#include "Aligned.hpp"
+#include "AsioDriver.hpp"
+#include "LockFreeQueue.hpp"
+#include "RtCheck.hpp"
+#include "SampleConvert.hpp"
+#include "XrunMonitor.hpp"
+
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace GigOn {
 
 class AsioContext final {
  public:
-  enum class DriverEvent { Overload };
+  // Events are delivered on the driver's thread, except for the ones
+  // following a reconfiguration, which come from the supervisor thread
+  enum class DriverEvent {
+    Overload,
+    LatenciesChanged,
+    SampleRateChanged,
+    BufferSizeChanged,
+    Reset,
+    Resynced,
+    ReconfigureFailed,
+  };
 
   struct Exception : public std::runtime_error {
     Exception(const std::string& msg, ASIOError errorCode);
@@ -43,21 +67,231 @@ class AsioContext final {
 
   using ChannelId = size_t;
 
+  // Latency breakdown in samples. Driver latencies already include
+  // the buffer, so BufferSize is informational and the round trip is
+  // input + output + processor latency. Valid after CreateBuffers();
+  // query it again on DriverEvent::LatenciesChanged
+  struct LatencyInformation {
+    size_t InputLatency = 0;
+    size_t OutputLatency = 0;
+    size_t BufferSize = 0;
+    size_t ProcessorLatency = 0;
+    ASIOSampleRate SampleRate = 0;
+
+    size_t GetRoundTrip() const;
+    double ToMicroseconds(size_t samples) const;
+  };
+
+  // Errors raised on the driver's thread. Driver callbacks never throw,
+  // they set these flags instead, see TakeRtErrors()
+  enum class RtError : uint32_t {
+    NoProcessor = 1 << 0,
+    BadBufferIndex = 1 << 1,
+    NoHandler = 1 << 2,
+    RequestDropped = 1 << 3,
+  };
+
+  // Everything called from the driver's thread is noexcept and must
+  // neither allocate nor lock. Configure() and SetSampleRate() run on
+  // the control thread, or on the supervisor thread while processing
+  // is suspended, so they never overlap with processing.
+
+  // Per-channel processor. The channel argument is the position of the
+  // buffer among the active inputs (or outputs), not the device channel
+  // number, so sparse channel selections map to a dense range
   struct IProcessor {
     virtual void Configure(size_t bufSize, size_t nInputs, size_t nOutputs) = 0;
     virtual void ProcessInput(long channel, void* buffer,
-                              ASIOSampleType type) = 0;
+                              ASIOSampleType type) noexcept = 0;
     virtual void ProcessOutput(long channel, void* buffer,
-                               ASIOSampleType type) = 0;
+                               ASIOSampleType type) noexcept = 0;
+
+    // Delay added by the processor in samples, e.g. the sum of the hosted
+    // plugins' initial delays. Is queried from the control thread
+    virtual size_t GetLatency() const { return 0; }
+
+    // Called before Configure() when the buffers are created and again,
+    // followed by Configure() with the same layout, when the device clock
+    // changes. Processors hosting plugins reconfigure them here
+    virtual void SetSampleRate(ASIOSampleRate sampleRate) {}
     virtual ~IProcessor() = default;
   };
 
+  // Resolved ASIO buffer of a single active channel.
+  // Position in Block::Inputs/Outputs is the active-buffer position,
+  // Channel is the device channel number. Converter is nullptr
+  // when the sample type is not supported
+  struct ChannelBuffer {
+    void* Buffer = nullptr;
+    const Helpers::SampleConverter* Converter = nullptr;
+    ASIOSampleType Type = 0;
+    long Channel = 0;
+  };
+
+  // Timing of a buffer switch as reported by the driver.
+  // SamplePosition is the position of the first sample of the block,
+  // SystemTime is in nanoseconds. Flags are ASIO's AsioTimeInfoFlags
+  // (kSamplePositionValid, kSystemTimeValid, kSpeedValid, ...), a field
+  // is only meaningful when its flag is set. Drivers without time info
+  // support are queried with GetSamplePosition() instead, so they provide
+  // the position and the system time only
+  struct TimeInfo {
+    int64_t SamplePosition = 0;
+    int64_t SystemTime = 0;
+    double Speed = 0;
+    ASIOSampleRate SampleRate = 0;
+    unsigned long Flags = 0;
+
+    bool IsValid(unsigned long flags) const { return (Flags & flags) == flags; }
+  };
+
+  // Everything a processor needs to handle one buffer switch.
+  // Spans point to the tables precomputed in CreateBuffers(), so
+  // they stay valid until DisposeBuffers() is called. Time is
+  // refreshed on every switch
+  struct Block {
+    long Index = 0;
+    size_t BufferSize = 0;
+    std::span<const ChannelBuffer> Inputs;
+    std::span<const ChannelBuffer> Outputs;
+    TimeInfo Time;
+  };
+
+  // Receives all the channels of a buffer switch in a single call,
+  // so the inputs may be read before any output is written
+  struct IBlockProcessor {
+    virtual void Configure(size_t bufSize, size_t nInputs, size_t nOutputs) = 0;
+    virtual void ProcessBlock(const Block& block) noexcept = 0;
+
+    // Same as in IProcessor
+    virtual size_t GetLatency() const { return 0; }
+    virtual void SetSampleRate(ASIOSampleRate sampleRate) {}
+    virtual ~IBlockProcessor() = default;
+  };
+
   struct IHandler {
-    virtual void HandleEvent(DriverEvent event) = 0;
+    virtual void HandleEvent(DriverEvent event) noexcept = 0;
     virtual ~IHandler() = default;
   };
 
+  // Anything that can handle a block. Does not have to be virtual
+  template <typename T>
+  static constexpr bool IsBlockProcessor =
+      requires(T& proc, const Block& block, size_t size) {
+        proc.Configure(size, size, size);
+        { proc.ProcessBlock(block) } noexcept;
+      };
+
+  // Buffer-switch path specialized for a processor type.
+  // Everything the callback needs is bound once, so the switch neither
+  // looks up the singleton nor checks the context state. When ProcT is
+  // a concrete (preferably final) type, ProcessBlock() is resolved at
+  // compile time and inlines into the callback. AsioContext binds it in
+  // SetHandlers(): Dispatch<IBlockProcessor> is the virtual path,
+  // SetStaticHandlers<ProcT>() installs Dispatch<ProcT>
+  template <typename ProcT>
+  struct Dispatch final {
+    // Swapped while running, see SwapProcessor()
+    static inline std::atomic<ProcT*> Instance = nullptr;
+    static inline Block* Blocks = nullptr;
+    static inline IAsioDriver* Driver = nullptr;
+    static inline bool PostOutput = false;
+    static inline Helpers::XrunMonitor* Monitor = nullptr;
+
+    // driver is queried for the sample position when it switches without
+    // time info and notified with OutputReady() if postOutput is set.
+    // It may be nullptr, then blocks carry no timing. monitor times
+    // every switch, nullptr disables timing
+    static void Bind(ProcT* instance, Block* blocks, IAsioDriver* driver,
+                     bool postOutput, Helpers::XrunMonitor* monitor) {
+      Instance.store(instance);
+      Blocks = blocks;
+      Driver = driver;
+      PostOutput = postOutput;
+      Monitor = monitor;
+    }
+
+    // Actual processing callback. Is called when all the buffers are about
+    // to be switched, so we need to take the data from inputs and put it
+    // to outputs.
+    static void BufferSwitch(long index, ASIOBool processNow) noexcept {
+      TimeInfo time;
+
+      ASIOSamples position;
+      ASIOTimeStamp timeStamp;
+
+      if (Driver && Driver->GetSamplePosition(&position, &timeStamp) == ASE_OK) {
+        time.SamplePosition = JoinInt64(position.hi, position.lo);
+        time.SystemTime = JoinInt64(timeStamp.hi, timeStamp.lo);
+        time.Flags = kSamplePositionValid | kSystemTimeValid;
+      }
+
+      Switch(index, time);
+    }
+
+    // Used instead of BufferSwitch() by drivers that support time info
+    static ASIOTime* BufferSwitchTimeInfo(ASIOTime* params, long index,
+                                          ASIOBool processNow) noexcept {
+      TimeInfo time;
+
+      if (params) {
+        const auto& info = params->timeInfo;
+
+        time.SamplePosition =
+            JoinInt64(info.samplePosition.hi, info.samplePosition.lo);
+        time.SystemTime = JoinInt64(info.systemTime.hi, info.systemTime.lo);
+        time.Speed = info.speed;
+        time.SampleRate = info.sampleRate;
+        time.Flags = info.flags;
+      }
+
+      Switch(index, time);
+      return nullptr;
+    }
+
+   private:
+    static void Switch(long index, const TimeInfo& time) noexcept {
+      Helpers::RtScope scope;
+      Helpers::XrunMonitor::Scope timing{Monitor};
+
+      if (index != 0 && index != 1) return RaiseRtError(RtError::BadBufferIndex);
+
+      auto& block = Blocks[index];
+      block.Time = time;
+
+      // Handshake with WaitForSwitch(): either the control side sees
+      // this switch in flight, or the switch sees the new processor
+      // and the suspension state
+      InSwitch.store(true);
+      ProcT* instance = Instance.load();
+
+      if (!instance)
+        RaiseRtError(RtError::NoProcessor);
+      else if (!Suspended.load())
+        instance->ProcessBlock(block);
+      else
+        SilenceOutputs(block);
+
+      InSwitch.store(false, std::memory_order_release);
+
+      if (PostOutput) Driver->OutputReady();
+    }
+  };
+
+  // Downtime of the reconfigurations run by the supervisor, from the
+  // driver's request to processing being resumed. Sample rate changes
+  // only suspend processing; buffer size changes and resets recreate
+  // the buffers with the same channels and processor, restarting the
+  // driver if it was running; resyncs just restart it
+  struct RecoveryInformation {
+    size_t Count = 0;
+    size_t Failures = 0;
+    double LastNs = 0;
+    double MaxNs = 0;
+  };
+
   using ProcessorT = std::unique_ptr<IProcessor>;
+  using BlockProcessorT = std::unique_ptr<IBlockProcessor>;
   using HandlerT = std::unique_ptr<IHandler>;
 
  private:
@@ -71,9 +305,14 @@ class AsioContext final {
     static constexpr auto AlreadyRunning = "Driver is already running";
     static constexpr auto NotRunning = "Driver is not running";
     static constexpr auto NoHandlersSet = "Handlers are not set";
+    static constexpr auto BadChannel = "Incorrect channel number";
+    static constexpr auto DispatchMismatch =
+        "Processor type differs from the installed dispatch";
   };
 
  private:
+  AsioDriverT Driver;
+
   ASIODriverInfo AsioInfo{};
   std::vector<ASIOBufferInfo> AsioBufferInfos;
 
@@ -86,11 +325,60 @@ class AsioContext final {
     size_t BufferSize = 0;
   } ActiveBuffersInfo;
 
+  // Flat per double-buffer half tables built in CreateBuffers():
+  // inputs go first, outputs follow. The buffer switch only walks them
+  Helpers::AlignedVector<ChannelBuffer> BlockChannels[2];
+  Block Blocks[2];
+
   ASIOCallbacks AsioCallbacks;
 
-  ProcessorT Processor;
+  BlockProcessorT Processor;
   HandlerT Handler;
 
+  Helpers::XrunMonitor Monitor;
+
+  static inline std::atomic<uint32_t> RtErrors{0};
+
+  // While suspended, switches output silence instead of processing
+  static inline std::atomic<bool> Suspended{false};
+  static inline std::atomic<bool> InSwitch{false};
+
+  // Driver requests that can't be served on the driver's thread.
+  // Callbacks push them, the supervisor thread handles them
+  struct Request {
+    enum class Kind {
+      SampleRateChange,
+      BufferSizeChange,
+      Reset,
+      Resync,
+    } Type;
+    ASIOSampleRate SampleRate = 0;
+    size_t BufferSize = 0;
+
+    // TscClock time the request was raised at
+    uint64_t RaisedAt = 0;
+  };
+
+  static constexpr size_t RequestQueueSize = 64;
+
+  Helpers::LockFreeQueue<Request, RequestQueueSize> Requests;
+  std::atomic<uint32_t> RequestSignal{0};
+  std::atomic<bool> SupervisorRunning{true};
+  std::thread Supervisor;
+
+  RecoveryInformation RecoveryInfo;
+
+  // Rebinds the dispatch installed by the last SetHandlers()
+  void (*RebindDispatch)(AsioContext&) = nullptr;
+
+  // Swapped out processors waiting for the supervisor to destroy them,
+  // ReclaimPending is set when there are new ones
+  std::vector<BlockProcessorT> Retired;
+  std::atomic<bool> ReclaimPending{false};
+
+  // Serializes the public API and the supervisor
+  mutable std::recursive_mutex ControlMutex;
+
   bool Loaded = false;
   bool Initialized = false;
   bool HandlersSet = false;
@@ -115,13 +403,34 @@ class AsioContext final {
  public:
   static AsioContext& Get();
 
+  // Loads an installed driver by name. SimAsioDriver::Name
+  // loads the simulated driver with default configuration
   void LoadDriver(const std::string& driverName);
+  void LoadDriver(AsioDriverT&& driver);
   void UnloadDriver();
 
   void InitDriver();
   void DeInitDriver();
 
   void SetHandlers(ProcessorT&& processor, HandlerT&& handler);
+  void SetHandlers(BlockProcessorT&& processor, HandlerT&& handler);
+
+  // Same as SetHandlers(), but the buffer switch calls
+  // ProcT::ProcessBlock() directly instead of through IBlockProcessor
+  template <typename ProcT>
+  void SetStaticHandlers(std::unique_ptr<ProcT>&& processor,
+                         HandlerT&& handler);
+
+  // Replace the processor while the buffers exist, running or not.
+  // The new processor is configured on the calling thread and picked up
+  // by the next buffer switch, the old one is destroyed on the supervisor
+  // thread once no switch uses it. SwapStaticProcessor() is for handlers
+  // installed with SetStaticHandlers<ProcT>() and takes the same type
+  void SwapProcessor(ProcessorT&& processor);
+  void SwapProcessor(BlockProcessorT&& processor);
+
+  template <typename ProcT>
+  void SwapStaticProcessor(std::unique_ptr<ProcT>&& processor);
 
   void CreateBuffers(const std::vector<ChannelId>& inputs,
                      const std::vector<ChannelId>& outputs, size_t bufferSize);
@@ -133,40 +442,170 @@ class AsioContext final {
   DeviceInformation GetDeviceInfo() const;
   ASIODriverInfo GetAsioInfo() const;
   BuffersInformation GetBuffersInfo() const;
+  LatencyInformation GetLatencyInfo() const;
+
+  // Buffer switch timing since the first CreateBuffers(), lock-free.
+  // Diff two snapshots with Since() to get an interval
+  Helpers::XrunMonitor::Snapshot GetXrunInfo() const;
+  RecoveryInformation GetRecoveryInfo() const;
 
   static std::vector<std::string> GetDriverNames(size_t maxNames);
 
+  // Returns RtError flags raised since the previous call and clears them
+  static uint32_t TakeRtErrors();
+  static bool HasRtError(uint32_t errors, RtError error);
+
  private:
-  static AsioDrivers& GetAsioDrivers();
   static void Expect(bool var, const char* msg);
 
   DeviceInformation GetDeviceInfoInternal() const;
-  void CheckBufferSize(long bufSize) const;
+  static void CheckBufferSize(const DeviceInformation& info, long bufSize);
+
+  // Buffer size and the channels of AsioBufferInfos against info
+  void CheckBufferLayout(const DeviceInformation& info,
+                         size_t bufferSize) const;
+
+  void CheckChannels(const std::vector<ChannelId>& channels,
+                     size_t available) const;
+  void BuildBlocks(size_t bufferSize);
+
+  // Creates buffers for the channels in AsioBufferInfos
+  void SetupBuffers(size_t bufferSize);
+
+  static void RaiseRtError(RtError error) noexcept;
+  static void NotifyHandler(DriverEvent event) noexcept;
+  static void SilenceOutputs(const Block& block) noexcept;
+
+  static Request MakeRequest(Request::Kind type) noexcept;
+  static void PostRequest(const Request& request) noexcept;
+  void WakeSupervisor() noexcept;
+  void SupervisorLoop();
+  void HandleRequest(const Request& request);
+  void HandleSampleRateChange(const Request& request);
+  void Recover(const Request& request);
+
+  // Destroys the retired processors once no switch uses them
+  void ReclaimRetired();
+
+  // Waits for the switch in flight, if any, to finish
+  static void WaitForSwitch();
+  void SuspendProcessing();
+  void ResumeProcessing();
+  void RecordRecovery(uint64_t raisedAt);
+
+  void StopSupervisor();
+
+  // ASIO passes 64-bit values as two 32-bit halves
+  static int64_t JoinInt64(unsigned long hi, unsigned long lo) noexcept {
+    return static_cast<int64_t>((uint64_t(hi) << 32) | (lo & 0xFFFFFFFF));
+  }
+
+  template <typename ProcT>
+  void BindDispatch(ProcT* processor);
 
-  // Actual processing callback. Is called when all the buffers are about
-  // to be switched, so we need to take the data from inputs and put it
-  // to outputs.
-  // For now this callback delegates everything to user callbacks via
-  // std::function. It could be changed to template-based strategy
-  // if profiling reveals such neccessity
-  static void AsioBufferSwitchCallback(long index, ASIOBool processNow);
+  template <typename ProcT>
+  static void RebindImpl(AsioContext& ctx);
 
-  // In fact, we do not need to process time information for now, so we simply
-  // redirect to simplier handler
-  static ASIOTime* AsioBufferSwitchTimeInfoCallback(ASIOTime* timeInfo,
-                                                    long index,
-                                                    ASIOBool processNow);
+  // Configures the processor for the active buffers
+  void PrepareProcessor(IBlockProcessor& processor);
 
-  static void AsioSampleRateChangedCallback(ASIOSampleRate sRate);
+  // Makes next the owned processor, the current one is retired.
+  // Dispatch must already point to next
+  void RetireProcessor(BlockProcessorT&& next);
+
+  static void AsioSampleRateChangedCallback(ASIOSampleRate sRate) noexcept;
 
   static long AsioMessageCallback(long selector, long value, void* message,
-                                  double* opt);
+                                  double* opt) noexcept;
 
   ASIOError DtorStopDriver();
   ASIOError DtorDisposeBuffers();
   ASIOError DtorExitDriver();
 };
 
+// Owns a processor of a concrete type for SetStaticHandlers().
+// The virtual ProcessBlock() is never called by the static dispatch
+template <typename ProcT>
+struct AsioStaticProcessor final : public AsioContext::IBlockProcessor {
+ private:
+  std::unique_ptr<ProcT> Impl;
+
+ public:
+  AsioStaticProcessor(std::unique_ptr<ProcT>&& impl)
+      : Impl{std::move(impl)} {}
+
+  void ProcessBlock(const AsioContext::Block& block) noexcept override {
+    Impl->ProcessBlock(block);
+  }
+
+  void Configure(size_t bufSize, size_t nInputs, size_t nOutputs) override {
+    Impl->Configure(bufSize, nInputs, nOutputs);
+  }
+
+  void SetSampleRate(ASIOSampleRate sampleRate) override {
+    if constexpr (requires(ProcT& proc) { proc.SetSampleRate(sampleRate); })
+      Impl->SetSampleRate(sampleRate);
+  }
+
+  size_t GetLatency() const override {
+    if constexpr (requires(const ProcT& proc) { proc.GetLatency(); })
+      return Impl->GetLatency();
+    else
+      return 0;
+  }
+
+  ProcT* Get() { return Impl.get(); }
+};
+
+template <typename ProcT>
+void AsioContext::BindDispatch(ProcT* processor) {
+  Dispatch<ProcT>::Bind(processor, Blocks, Driver.get(), PostOutput,
+                        &Monitor);
+
+  RebindDispatch = &RebindImpl<ProcT>;
+
+  AsioCallbacks.bufferSwitch = Dispatch<ProcT>::BufferSwitch;
+  AsioCallbacks.bufferSwitchTimeInfo = Dispatch<ProcT>::BufferSwitchTimeInfo;
+}
+
+template <typename ProcT>
+void AsioContext::RebindImpl(AsioContext& ctx) {
+  Dispatch<ProcT>::Bind(Dispatch<ProcT>::Instance.load(), ctx.Blocks,
+                        ctx.Driver.get(), ctx.PostOutput, &ctx.Monitor);
+}
+
+template <typename ProcT>
+void AsioContext::SwapStaticProcessor(std::unique_ptr<ProcT>&& processor) {
+  std::lock_guard lock{ControlMutex};
+
+  Expect(BuffersCreated, Msg::BuffersAbsent);
+  Expect(RebindDispatch == &RebindImpl<ProcT>, Msg::DispatchMismatch);
+
+  auto holder = std::make_unique<AsioStaticProcessor<ProcT>>(
+      std::move(processor));
+
+  PrepareProcessor(*holder);
+  Dispatch<ProcT>::Instance.store(holder->Get());
+
+  RetireProcessor(std::move(holder));
+}
+
+template <typename ProcT>
+void AsioContext::SetStaticHandlers(std::unique_ptr<ProcT>&& processor,
+                                    HandlerT&& handler) {
+  static_assert(IsBlockProcessor<ProcT>,
+                "ProcT must provide Configure() and ProcessBlock()");
+
+  std::lock_guard lock{ControlMutex};
+
+  auto holder = std::make_unique<AsioStaticProcessor<ProcT>>(
+      std::move(processor));
+  ProcT* impl = holder->Get();
+
+  SetHandlers(std::move(holder), std::move(handler));
+  BindDispatch(impl);
+}
+
 namespace Helpers {
 struct AsioProcessorMock final : public AsioContext::IProcessor {
  private:
@@ -178,8 +617,10 @@ struct AsioProcessorMock final : public AsioContext::IProcessor {
   AsioProcessorMock(decltype(ProcessInputFunc), decltype(ProcessOutputFunc),
                   decltype(ConfigureFunc));
 
-  void ProcessInput(long channel, void* buf, ASIOSampleType type) override;
-  void ProcessOutput(long channel, void* buf, ASIOSampleType type) override;
+  void ProcessInput(long channel, void* buf,
+                    ASIOSampleType type) noexcept override;
+  void ProcessOutput(long channel, void* buf,
+                     ASIOSampleType type) noexcept override;
   void Configure(size_t bufSize, size_t nInputs, size_t nOutputs) override;
 
   static AsioContext::ProcessorT Create(decltype(ProcessInputFunc),
@@ -187,18 +628,54 @@ struct AsioProcessorMock final : public AsioContext::IProcessor {
                                       decltype(ConfigureFunc));
 };
 
+// Adapts per-channel IProcessor to the block interface.
+// Calls ProcessInput() for every input, then ProcessOutput() for every output
+struct AsioChannelAdapter final : public AsioContext::IBlockProcessor {
+ private:
+  AsioContext::ProcessorT Processor;
+
+ public:
+  AsioChannelAdapter(AsioContext::ProcessorT&& processor);
+
+  void ProcessBlock(const AsioContext::Block& block) noexcept override;
+  void Configure(size_t bufSize, size_t nInputs, size_t nOutputs) override;
+  size_t GetLatency() const override;
+  void SetSampleRate(ASIOSampleRate sampleRate) override;
+
+  static AsioContext::BlockProcessorT Create(AsioContext::ProcessorT&&);
+};
+
+struct AsioBlockProcessorMock final : public AsioContext::IBlockProcessor {
+ private:
+  std::function<void(const AsioContext::Block&)> ProcessBlockFunc;
+  std::function<void(size_t, size_t, size_t)> ConfigureFunc;
+
+ public:
+  AsioBlockProcessorMock(decltype(ProcessBlockFunc), decltype(ConfigureFunc));
+
+  void ProcessBlock(const AsioContext::Block& block) noexcept override;
+  void Configure(size_t bufSize, size_t nInputs, size_t nOutputs) override;
+
+  static AsioContext::BlockProcessorT Create(decltype(ProcessBlockFunc),
+                                           decltype(ConfigureFunc));
+};
+
 struct AsioHandlerMock final : public AsioContext::IHandler {
  private:
   std::function<void(AsioContext::DriverEvent)> HandleFunc;
 
  public:
   AsioHandlerMock(decltype(HandleFunc));
-  void HandleEvent(AsioContext::DriverEvent) override;
+  void HandleEvent(AsioContext::DriverEvent) noexcept override;
 
   static AsioContext::HandlerT Create(decltype(HandleFunc));
 };
 
 void DumpAsioInfo(std::ostream& out, const ASIODriverInfo& info);
+void DumpLatencyInfo(std::ostream& out,
+                     const AsioContext::LatencyInformation& info);
+void DumpXrunInfo(std::ostream& out,
+                  const Helpers::XrunMonitor::Snapshot& info);
 void DumpDeviceInfo(std::ostream& out,
                     const AsioContext::DeviceInformation& info);
 const char* ASIOErrorToStr(ASIOError error);
@@ -0,0 +1,52 @@
+#pragma once
+
+// asiosys needs to be included first
+// clang-format off
+#include "asiosys.h"
+#include "asio.h"
+// clang-format on
+
+#include <memory>
+
+namespace GigOn {
+
+// Driver backend used by AsioContext. Mirrors the ASIO host API
+// (ASIOInit(), ASIOCreateBuffers(), ...) one to one, including its
+// error reporting, so SDK drivers and in-process backends are
+// interchangeable. OutputReady() and GetSamplePosition() are called
+// from the buffer switch, the rest from the control thread
+struct IAsioDriver {
+  virtual ASIOError Init(ASIODriverInfo* info) noexcept = 0;
+  virtual ASIOError Exit() noexcept = 0;
+
+  virtual ASIOError Start() noexcept = 0;
+  virtual ASIOError Stop() noexcept = 0;
+
+  virtual ASIOError GetChannels(long* numInputs, long* numOutputs) noexcept = 0;
+  virtual ASIOError GetLatencies(long* inputLatency,
+                                 long* outputLatency) noexcept = 0;
+  virtual ASIOError GetBufferSize(long* minSize, long* maxSize, long* prefSize,
+                                  long* granularity) noexcept = 0;
+
+  virtual ASIOError CanSampleRate(ASIOSampleRate sampleRate) noexcept = 0;
+  virtual ASIOError GetSampleRate(ASIOSampleRate* sampleRate) noexcept = 0;
+  virtual ASIOError SetSampleRate(ASIOSampleRate sampleRate) noexcept = 0;
+
+  virtual ASIOError GetSamplePosition(ASIOSamples* samplePos,
+                                      ASIOTimeStamp* timeStamp) noexcept = 0;
+  virtual ASIOError GetChannelInfo(ASIOChannelInfo* info) noexcept = 0;
+
+  virtual ASIOError CreateBuffers(ASIOBufferInfo* bufferInfos, long numChannels,
+                                  long bufferSize,
+                                  ASIOCallbacks* callbacks) noexcept = 0;
+  virtual ASIOError DisposeBuffers() noexcept = 0;
+
+  virtual ASIOError OutputReady() noexcept = 0;
+  virtual ASIOError Future(long selector, void* opt) noexcept = 0;
+
+  virtual ~IAsioDriver() = default;
+};
+
+using AsioDriverT = std::unique_ptr<IAsioDriver>;
+
+}  // namespace GigOn
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace GigOn {
+
+// Hands out cache-line aligned blocks for audio buffers from a few large
+// regions. Regions are faulted in when they are mapped and can be backed
+// by huge pages and locked into RAM, both best effort: GetStats() tells
+// what was granted. Blocks are never freed one by one, Reset() recycles
+// all of them at once and Release() returns the regions to the OS.
+// Every region stays resident, so an engine keeps one arena for its
+// whole chain rather than one per plugin.
+// Not thread-safe, allocate on the control thread
+class BufferArena final {
+ public:
+  struct Config {
+    // Blocks larger than a region get a region of their own
+    size_t RegionSize = 4 << 20;
+    bool HugePages = false;
+    bool Lock = false;
+  };
+
+  struct Stats {
+    size_t Regions = 0;
+    size_t HugePageRegions = 0;
+    size_t LockedRegions = 0;
+    size_t ReservedBytes = 0;
+    size_t UsedBytes = 0;
+  };
+
+ private:
+  struct Region {
+    uint8_t* Base = nullptr;
+    size_t Size = 0;
+    size_t Used = 0;
+    bool HugePages = false;
+    bool Locked = false;
+  };
+
+  Config Conf;
+  std::vector<Region> Regions;
+
+  // Regions before it are full
+  size_t Current = 0;
+
+ public:
+  BufferArena();
+  explicit BufferArena(const Config& config);
+
+  BufferArena(const BufferArena&) = delete;
+  BufferArena& operator=(const BufferArena&) = delete;
+
+  // Blocks stay where they are
+  BufferArena(BufferArena&& other) noexcept;
+  BufferArena& operator=(BufferArena&& other) noexcept;
+
+  ~BufferArena();
+
+  // Zeroed block of at least bytes, aligned on a cache line.
+  // Throws std::bad_alloc if no region can be mapped
+  void* Allocate(size_t bytes);
+
+  template <typename T>
+  T* Allocate(size_t count) {
+    return static_cast<T*>(Allocate(count * sizeof(T)));
+  }
+
+  // Invalidates every block, the regions are kept for reuse
+  void Reset();
+
+  // Invalidates every block and unmaps the regions
+  void Release();
+
+  Stats GetStats() const;
+  const Config& GetConfig() const;
+
+ private:
+  Region MapRegion(size_t bytes) const;
+  static void UnmapRegion(const Region& region);
+};
+
+}  // namespace GigOn
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace GigOn {
+namespace Helpers {
+
+// High dynamic range histogram of unsigned values with a fixed relative
+// precision of 1/SubBucketCount: values below SubBucketCount are counted
+// exactly, larger ones fall into log-linear buckets. Values above the
+// maximum are clamped to it.
+// Record() is wait-free and meant for a single writer thread, any number
+// of readers may take snapshots concurrently. Counts only grow, so the
+// difference of two snapshots is the histogram of the interval
+class HdrHistogram final {
+ public:
+  static constexpr uint64_t SubBucketBits = 7;
+  static constexpr uint64_t SubBucketCount = 1 << SubBucketBits;
+
+  struct Snapshot {
+    std::vector<uint64_t> Counts;
+    uint64_t TotalCount = 0;
+
+    // Lowest value v such that p percent of the values are <= v,
+    // reported with the bucket precision. 0 for an empty snapshot
+    uint64_t GetValueAtPercentile(double percentile) const;
+    uint64_t GetMax() const;
+    double GetMean() const;
+
+    // Histogram of the values recorded after earlier was taken
+    Snapshot Since(const Snapshot& earlier) const;
+  };
+
+ private:
+  uint64_t MaxValue = 0;
+  size_t NumBuckets = 0;
+  std::unique_ptr<std::atomic<uint64_t>[]> Counts;
+  std::atomic<uint64_t> TotalCount = 0;
+
+ public:
+  HdrHistogram(uint64_t maxValue);
+
+  HdrHistogram(const HdrHistogram&) = delete;
+  HdrHistogram& operator=(const HdrHistogram&) = delete;
+
+  void Record(uint64_t value) noexcept {
+    if (value > MaxValue) value = MaxValue;
+
+    // Single writer: plain increments, readers only need atomicity
+    auto& count = Counts[GetBucket(value)];
+    count.store(count.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+    TotalCount.store(TotalCount.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_release);
+  }
+
+  Snapshot TakeSnapshot() const;
+  uint64_t GetMaxValue() const;
+
+  static size_t GetBucket(uint64_t value) noexcept {
+    // Shift that brings the value into [SubBucketCount, 2 * SubBucketCount)
+    int width = std::bit_width(value);
+    int shift = width > int(SubBucketBits + 1) ? width - SubBucketBits - 1 : 0;
+
+    return (size_t(shift) << SubBucketBits) + (value >> shift);
+  }
+
+  // Smallest and largest values counted in the bucket
+  static uint64_t GetBucketLow(size_t bucket);
+  static uint64_t GetBucketHigh(size_t bucket);
+};
+
+}  // namespace Helpers
+}  // namespace GigOn
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+
+#include "SampleConvert.hpp"
+
+namespace GigOn {
+namespace Helpers {
+
+// Instruction set a kernel table is built for. Every table computes
+// bit-identical results, only the speed differs
+enum class CpuTier { Scalar, Sse2, Avx2, Avx512, Neon };
+
+// Hot loops, one implementation per CpuTier
+struct KernelTable {
+  // dst[i] += src[i] * gain
+  using MixFn = void (*)(const float* src, float* dst, float gain,
+                         size_t size);
+  // dst[i] = src[i] * gain, src may be dst
+  using GainFn = void (*)(const float* src, float* dst, float gain,
+                          size_t size);
+  // max(peak, |src[i]|) over the buffer
+  using PeakFn = float (*)(const float* src, size_t size, float peak);
+
+  CpuTier Tier = CpuTier::Scalar;
+
+  MixFn Mix = nullptr;
+  GainFn Gain = nullptr;
+  PeakFn Peak = nullptr;
+
+  // Indexed by ASIOSampleType, empty for unsupported formats
+  SampleConverter Converters[ASIOSTLastEntry] = {};
+};
+
+// Name of the environment variable overriding the probed tier,
+// e.g. GIGON_CPU_TIER=sse2. Tiers the CPU can't run are ignored
+constexpr auto CpuTierVariable = "GIGON_CPU_TIER";
+
+const char* CpuTierToStr(CpuTier tier);
+
+// True if this build has the tier and the CPU and OS can run it
+bool IsSupported(CpuTier tier);
+
+// Best supported tier, probed once
+CpuTier GetBestTier();
+
+// Table of the best tier or of the override. Bound on the first call,
+// which has to happen off the real-time thread: AsioContext does it
+// when it is created
+const KernelTable& GetKernels();
+
+// Table of a specific tier, nullptr if it is not supported.
+// For benchmarks and tests
+const KernelTable* GetKernels(CpuTier tier);
+
+}  // namespace Helpers
+}  // namespace GigOn
@@ -0,0 +1,627 @@
+#pragma once
+
+// Kernel templates shared by the per-tier translation units
+// (Src/Kernels<Tier>.cpp), each compiled for its own instruction set.
+// Everything here has internal linkage, so the linker can't merge
+// an AVX2 build of a helper into the scalar table. That rules out the
+// inline functions of the standard library too (std::fabs, std::bit_cast
+// and the like), unoptimized builds emit them as weak symbols, one copy
+// per tier. Use the builtin wrappers below instead
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "Kernels.hpp"
+
+#undef max  // I hate windows
+
+namespace GigOn {
+namespace Helpers {
+
+namespace {
+
+// Every format gets its own whole-buffer kernel pair: the vector loop
+// handles as many samples as it can and the scalar loop finishes the
+// tail. Both round the same way, so the result does not depend on where
+// the split falls.
+//
+// Integer -> float divides by the largest positive sample. Float ->
+// integer clips to [-1, 1], scales by that value + .49999 in double
+// precision and truncates, like ASIOConvertSamples::float32toIntXXinPlace.
+// Float formats are passed through without clipping.
+//
+// The dithered float -> integer kernels work in LSBs instead: scale by
+// the largest positive sample in single precision, add the dither,
+// saturate to the format's range and round to nearest. Formats wider
+// than 24 bits don't go through them, float can't hold their LSB.
+//
+// Double-precision host samples have scalar kernels only. Integers are
+// scaled and quantized like above, all in double, so 32-bit formats
+// keep every bit
+
+constexpr bool IsLittleEndian = std::endian::native == std::endian::little;
+
+template <typename To, typename From>
+To BitCast(From value) {
+  return __builtin_bit_cast(To, value);
+}
+
+inline float Abs(float value) { return __builtin_fabsf(value); }
+
+// Round to nearest in the current rounding mode, like std::nearbyint
+inline float RoundNearest(float value) { return __builtin_nearbyintf(value); }
+inline double RoundNearest(double value) { return __builtin_nearbyint(value); }
+
+// Integer samples with Bits significant bits, right-aligned in a T
+// container. ASIOSTInt32LSB24 is IntFormat<int32_t, 24, ...>
+template <typename T, int Bits, bool Swapped>
+struct IntFormat {
+  using Type = T;
+  static constexpr bool Swap = Swapped;
+  static constexpr int Shift = 8 * sizeof(T) - Bits;
+  static constexpr int32_t Max = (int64_t(1) << (Bits - 1)) - 1;
+  static constexpr float ToFloatScale = 1.f / Max;
+  static constexpr double ToDoubleScale = 1. / Max;
+  static constexpr double FromFloatScale = Max + .49999;
+};
+
+// Packed 3-byte samples
+template <bool Swapped>
+struct Int24Format {
+  static constexpr size_t Size = 3;
+  static constexpr bool Swap = Swapped;
+  static constexpr int32_t Max = 0x7fffff;
+  static constexpr float ToFloatScale = 1.f / Max;
+  static constexpr double ToDoubleScale = 1. / Max;
+  static constexpr double FromFloatScale = Max + .49999;
+};
+
+template <typename T, bool Swapped>
+struct FloatFormat {
+  using Type = T;
+  static constexpr bool Swap = Swapped;
+};
+
+template <typename T>
+T ByteSwap(T value) {
+  using U = std::make_unsigned_t<T>;
+  U in = U(value);
+  U out = 0;
+
+  for (size_t i = 0; i < sizeof(T); ++i)
+    out = U(out << 8) | U((in >> (8 * i)) & 0xff);
+
+  return T(out);
+}
+
+template <typename T, bool Swap>
+T Load(const void* src, size_t index) {
+  T value;
+  std::memcpy(&value, static_cast<const uint8_t*>(src) + index * sizeof(T),
+              sizeof(T));
+
+  if constexpr (Swap) {
+    using U = std::conditional_t<sizeof(T) == 8, uint64_t, uint32_t>;
+    if constexpr (std::is_floating_point_v<T>)
+      return BitCast<T>(ByteSwap(BitCast<U>(value)));
+    else
+      return ByteSwap(value);
+  }
+
+  return value;
+}
+
+template <typename T, bool Swap>
+void Store(void* dst, size_t index, T value) {
+  if constexpr (Swap) {
+    using U = std::conditional_t<sizeof(T) == 8, uint64_t, uint32_t>;
+    if constexpr (std::is_floating_point_v<T>)
+      value = BitCast<T>(ByteSwap(BitCast<U>(value)));
+    else
+      value = ByteSwap(value);
+  }
+
+  std::memcpy(static_cast<uint8_t*>(dst) + index * sizeof(T), &value,
+              sizeof(T));
+}
+
+// Same NaN behaviour as maxps/minps: NaN becomes -1
+inline float Clip(float value) {
+  value = value > -1.f ? value : -1.f;
+  return value < 1.f ? value : 1.f;
+}
+
+inline double Clip(double value) {
+  value = value > -1. ? value : -1.;
+  return value < 1. ? value : 1.;
+}
+
+template <typename Format>
+int32_t Quantize(float value) {
+  return int32_t(double(Clip(value)) * Format::FromFloatScale);
+}
+
+template <typename Format>
+int32_t Quantize(double value) {
+  return int32_t(Clip(value) * Format::FromFloatScale);
+}
+
+// Dither generator, see DitherState. The vector kernels implement
+// the same steps lane by lane
+
+inline uint32_t NextRandom(uint32_t& x) {
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return x;
+}
+
+// Difference of the two 16-bit halves: triangular in (-1, 1)
+inline float TpdfNoise(uint32_t random) {
+  return float(int32_t(random & 0xffff) - int32_t(random >> 16)) *
+         (1.f / 65536);
+}
+
+// Uniform in [-.5, .5]. The difference of two successive
+// draws is triangular and rises with frequency
+inline float UniformNoise(uint32_t random) {
+  return float(int32_t(random)) * 0x1p-32f;
+}
+
+// Dither for sample i of the buffer, in LSBs
+template <DitherMode Mode>
+float NextDither(DitherState& state, size_t i) {
+  if constexpr (Mode == DitherMode::None) return 0.f;
+
+  uint32_t random = NextRandom(state.Random[i % DitherState::Lanes]);
+  if constexpr (Mode == DitherMode::Tpdf) return TpdfNoise(random);
+
+  float uniform = UniformNoise(random);
+  float dither = uniform - state.Last;
+  state.Last = uniform;
+  return dither;
+}
+
+// Same NaN behaviour as Clip(), rounds like cvtps2dq does by default
+template <typename Format>
+int32_t QuantizeDithered(float value, float dither) {
+  constexpr float max = float(Format::Max);
+
+  value = value * max + dither;
+  value = value > -max - 1.f ? value : -max - 1.f;
+  value = value < max ? value : max;
+  return int32_t(RoundNearest(value));
+}
+
+template <typename Format>
+int32_t QuantizeDithered(double value, double dither) {
+  constexpr double max = Format::Max;
+
+  value = value * max + dither;
+  value = value > -max - 1. ? value : -max - 1.;
+  value = value < max ? value : max;
+  return int32_t(RoundNearest(value));
+}
+
+// Integer sample as int32_t, sign-extended
+template <typename T, int Bits, bool Swap>
+int32_t LoadInt(IntFormat<T, Bits, Swap>, const void* src, size_t index) {
+  using Format = IntFormat<T, Bits, Swap>;
+
+  int32_t value = Load<T, Swap>(src, index);
+  if constexpr (Format::Shift > 0)
+    value = int32_t(uint32_t(value) << Format::Shift) >> Format::Shift;
+
+  return value;
+}
+
+template <bool Swap>
+int32_t LoadInt(Int24Format<Swap>, const void* src, size_t index) {
+  const uint8_t* sample = static_cast<const uint8_t*>(src) + 3 * index;
+  constexpr size_t lo = Swap ? 2 : 0;
+  constexpr size_t hi = Swap ? 0 : 2;
+
+  // Assemble in the top bytes, the shift back sign-extends
+  uint32_t raw = uint32_t(sample[lo]) << 8 | uint32_t(sample[1]) << 16 |
+                 uint32_t(sample[hi]) << 24;
+  return int32_t(raw) >> 8;
+}
+
+template <bool Swap>
+void StoreInt24(void* dst, size_t index, uint32_t value) {
+  uint8_t* sample = static_cast<uint8_t*>(dst) + 3 * index;
+  constexpr size_t lo = Swap ? 2 : 0;
+  constexpr size_t hi = Swap ? 0 : 2;
+
+  sample[lo] = uint8_t(value);
+  sample[1] = uint8_t(value >> 8);
+  sample[hi] = uint8_t(value >> 16);
+}
+
+// Float side of the plain kernels: sample i stays as it is
+struct Unity {
+  float operator()(float value, size_t) const { return value; }
+};
+
+// Float side of the fused kernels: gain ramp and meter, see MeterState
+struct Strip {
+  float Gain;
+  float Step;
+  MeterState& Meter;
+
+  float operator()(float value, size_t i) {
+    value *= Gain + Step * float(i + 1);
+
+    // NaN is skipped, like in Peak()
+    float magnitude = Abs(value);
+    Meter.Peak = magnitude > Meter.Peak ? magnitude : Meter.Peak;
+    Meter.Squares[i % MeterState::Lanes] += value * value;
+
+    return value;
+  }
+};
+
+// Scalar kernels start at sample `begin`, so they can finish what
+// the vector kernels have left. process(value, i) runs on the float
+// side of every sample
+
+template <typename T, int Bits, bool Swap, typename Process>
+void ScalarToFloat(IntFormat<T, Bits, Swap>, const void* src, float* dst,
+                   size_t begin, size_t size, Process&& process) {
+  using Format = IntFormat<T, Bits, Swap>;
+
+  for (size_t i = begin; i < size; ++i) {
+    int32_t val = LoadInt(Format{}, src, i);
+    dst[i] = process(float(val) * Format::ToFloatScale, i);
+  }
+}
+
+template <typename T, int Bits, bool Swap, typename Process>
+void ScalarFromFloat(IntFormat<T, Bits, Swap>, const float* src, void* dst,
+                     size_t begin, size_t size, Process&& process) {
+  using Format = IntFormat<T, Bits, Swap>;
+
+  for (size_t i = begin; i < size; ++i)
+    Store<T, Swap>(dst, i, T(Quantize<Format>(process(src[i], i))));
+}
+
+template <bool Swap, typename Process>
+void ScalarToFloat(Int24Format<Swap>, const void* src, float* dst,
+                   size_t begin, size_t size, Process&& process) {
+  using Format = Int24Format<Swap>;
+
+  for (size_t i = begin; i < size; ++i) {
+    int32_t val = LoadInt(Format{}, src, i);
+    dst[i] = process(float(val) * Format::ToFloatScale, i);
+  }
+}
+
+template <bool Swap, typename Process>
+void ScalarFromFloat(Int24Format<Swap>, const float* src, void* dst,
+                     size_t begin, size_t size, Process&& process) {
+  using Format = Int24Format<Swap>;
+
+  for (size_t i = begin; i < size; ++i)
+    StoreInt24<Swap>(dst, i, Quantize<Format>(process(src[i], i)));
+}
+
+template <DitherMode Mode, typename T, int Bits, bool Swap, typename Process>
+void ScalarDither(IntFormat<T, Bits, Swap>, const float* src, void* dst,
+                  size_t begin, size_t size, DitherState& state,
+                  Process&& process) {
+  using Format = IntFormat<T, Bits, Swap>;
+
+  for (size_t i = begin; i < size; ++i) {
+    float value = process(src[i], i);
+    float dither = NextDither<Mode>(state, i);
+    Store<T, Swap>(dst, i, T(QuantizeDithered<Format>(value, dither)));
+  }
+}
+
+template <DitherMode Mode, bool Swap, typename Process>
+void ScalarDither(Int24Format<Swap>, const float* src, void* dst,
+                  size_t begin, size_t size, DitherState& state,
+                  Process&& process) {
+  using Format = Int24Format<Swap>;
+
+  for (size_t i = begin; i < size; ++i) {
+    float value = process(src[i], i);
+    float dither = NextDither<Mode>(state, i);
+    StoreInt24<Swap>(dst, i, QuantizeDithered<Format>(value, dither));
+  }
+}
+
+template <typename T, bool Swap, typename Process>
+void ScalarToFloat(FloatFormat<T, Swap>, const void* src, float* dst,
+                   size_t begin, size_t size, Process&& process) {
+  for (size_t i = begin; i < size; ++i)
+    dst[i] = process(float(Load<T, Swap>(src, i)), i);
+}
+
+template <typename T, bool Swap, typename Process>
+void ScalarFromFloat(FloatFormat<T, Swap>, const float* src, void* dst,
+                     size_t begin, size_t size, Process&& process) {
+  for (size_t i = begin; i < size; ++i)
+    Store<T, Swap>(dst, i, T(process(src[i], i)));
+}
+
+// Every tier defines these. They return the number of samples processed,
+// the scalar loops below finish the rest. Tiers without a vector loop
+// for a format return 0.
+//
+// Kernels with state have to leave it as if the scalar loop had done
+// their part: sample i of the call uses lane i % Lanes of DitherState
+// and MeterState
+
+template <typename Format>
+size_t VectorToFloat(Format, const void* src, float* dst, size_t size);
+
+template <typename Format>
+size_t VectorFromFloat(Format, const float* src, void* dst, size_t size);
+
+template <DitherMode Mode, typename Format>
+size_t VectorDither(Format, const float* src, void* dst, size_t size,
+                    DitherState& state);
+
+template <typename Format>
+size_t VectorToFloatGain(Format, const void* src, float* dst, size_t size,
+                         float gain, float step, MeterState& meter);
+
+// Called with DitherMode::None for formats without dither
+template <DitherMode Mode, typename Format>
+size_t VectorFromFloatGain(Format, const float* src, void* dst, size_t size,
+                           float gain, float step, MeterState& meter,
+                           DitherState& dither);
+
+size_t VectorMix(const float* src, float* dst, float gain, size_t size);
+size_t VectorGain(const float* src, float* dst, float gain, size_t size);
+size_t VectorPeak(const float* src, size_t size, float& peak);
+
+void Mix(const float* src, float* dst, float gain, size_t size) {
+  for (size_t i = VectorMix(src, dst, gain, size); i < size; ++i)
+    dst[i] += src[i] * gain;
+}
+
+void Gain(const float* src, float* dst, float gain, size_t size) {
+  for (size_t i = VectorGain(src, dst, gain, size); i < size; ++i)
+    dst[i] = src[i] * gain;
+}
+
+// NaN is skipped, like maxps(value, peak) does
+float Peak(const float* src, size_t size, float peak) {
+  for (size_t i = VectorPeak(src, size, peak); i < size; ++i) {
+    float value = Abs(src[i]);
+    peak = value > peak ? value : peak;
+  }
+
+  return peak;
+}
+
+// Native float needs no conversion at all
+template <typename Format>
+constexpr bool IsNativeFloat = std::is_same_v<Format, FloatFormat<float, false>>;
+
+template <typename Format>
+void ToFloat(const void* src, float* dst, size_t size) {
+  if constexpr (IsNativeFloat<Format>) {
+    std::memcpy(dst, src, size * sizeof(float));
+  } else {
+    size_t done = VectorToFloat(Format{}, src, dst, size);
+    ScalarToFloat(Format{}, src, dst, done, size, Unity{});
+  }
+}
+
+template <typename Format>
+void FromFloat(const float* src, void* dst, size_t size) {
+  if constexpr (IsNativeFloat<Format>) {
+    std::memcpy(dst, src, size * sizeof(float));
+  } else {
+    size_t done = VectorFromFloat(Format{}, src, dst, size);
+    ScalarFromFloat(Format{}, src, dst, done, size, Unity{});
+  }
+}
+
+template <typename Format>
+constexpr bool IsFloat = false;
+
+template <typename T, bool Swap>
+constexpr bool IsFloat<FloatFormat<T, Swap>> = true;
+
+template <typename Format>
+constexpr bool IsDithered = false;
+
+template <typename T, int Bits, bool Swap>
+constexpr bool IsDithered<IntFormat<T, Bits, Swap>> = Bits <= 24;
+
+template <bool Swap>
+constexpr bool IsDithered<Int24Format<Swap>> = true;
+
+template <DitherMode Mode, typename Format>
+void Dither(Format, const float* src, void* dst, size_t size,
+            DitherState& state) {
+  size_t done = VectorDither<Mode>(Format{}, src, dst, size, state);
+  ScalarDither<Mode>(Format{}, src, dst, done, size, state, Unity{});
+}
+
+template <typename Format>
+void FromFloatDither(const float* src, void* dst, size_t size,
+                     DitherState& state) {
+  if constexpr (!IsDithered<Format>) {
+    FromFloat<Format>(src, dst, size);
+  } else {
+    switch (state.Mode) {
+      case DitherMode::None:
+        return Dither<DitherMode::None>(Format{}, src, dst, size, state);
+      case DitherMode::Tpdf:
+        return Dither<DitherMode::Tpdf>(Format{}, src, dst, size, state);
+      case DitherMode::Shaped:
+        return Dither<DitherMode::Shaped>(Format{}, src, dst, size, state);
+    }
+  }
+}
+
+template <typename Format>
+void ToFloatGain(const void* src, float* dst, size_t size, float gain,
+                 float step, MeterState& meter) {
+  size_t done = VectorToFloatGain(Format{}, src, dst, size, gain, step, meter);
+  ScalarToFloat(Format{}, src, dst, done, size, Strip{gain, step, meter});
+}
+
+template <DitherMode Mode, typename Format>
+void DitherGain(Format, const float* src, void* dst, size_t size, float gain,
+                float step, MeterState& meter, DitherState& dither) {
+  size_t done = VectorFromFloatGain<Mode>(Format{}, src, dst, size, gain, step,
+                                          meter, dither);
+  ScalarDither<Mode>(Format{}, src, dst, done, size, dither,
+                     Strip{gain, step, meter});
+}
+
+template <typename Format>
+void FromFloatGain(const float* src, void* dst, size_t size, float gain,
+                   float step, MeterState& meter, DitherState& dither) {
+  if constexpr (!IsDithered<Format>) {
+    size_t done = VectorFromFloatGain<DitherMode::None>(
+        Format{}, src, dst, size, gain, step, meter, dither);
+    ScalarFromFloat(Format{}, src, dst, done, size, Strip{gain, step, meter});
+  } else {
+    switch (dither.Mode) {
+      case DitherMode::None:
+        return DitherGain<DitherMode::None>(Format{}, src, dst, size, gain,
+                                            step, meter, dither);
+      case DitherMode::Tpdf:
+        return DitherGain<DitherMode::Tpdf>(Format{}, src, dst, size, gain,
+                                            step, meter, dither);
+      case DitherMode::Shaped:
+        return DitherGain<DitherMode::Shaped>(Format{}, src, dst, size, gain,
+                                              step, meter, dither);
+    }
+  }
+}
+
+template <typename Format>
+constexpr bool IsNativeDouble =
+    std::is_same_v<Format, FloatFormat<double, false>>;
+
+template <typename T, int Bits, bool Swap>
+void StoreInt(IntFormat<T, Bits, Swap>, void* dst, size_t index,
+              int32_t value) {
+  Store<T, Swap>(dst, index, T(value));
+}
+
+template <bool Swap>
+void StoreInt(Int24Format<Swap>, void* dst, size_t index, int32_t value) {
+  StoreInt24<Swap>(dst, index, value);
+}
+
+template <typename Format>
+void ToDouble(const void* src, double* dst, size_t size) {
+  if constexpr (IsNativeDouble<Format>) {
+    std::memcpy(dst, src, size * sizeof(double));
+  } else if constexpr (IsFloat<Format>) {
+    using T = typename Format::Type;
+    for (size_t i = 0; i < size; ++i)
+      dst[i] = double(Load<T, Format::Swap>(src, i));
+  } else {
+    for (size_t i = 0; i < size; ++i)
+      dst[i] = double(LoadInt(Format{}, src, i)) * Format::ToDoubleScale;
+  }
+}
+
+template <typename Format>
+void FromDouble(const double* src, void* dst, size_t size) {
+  if constexpr (IsNativeDouble<Format>) {
+    std::memcpy(dst, src, size * sizeof(double));
+  } else if constexpr (IsFloat<Format>) {
+    using T = typename Format::Type;
+    for (size_t i = 0; i < size; ++i)
+      Store<T, Format::Swap>(dst, i, T(src[i]));
+  } else {
+    for (size_t i = 0; i < size; ++i)
+      StoreInt(Format{}, dst, i, Quantize<Format>(src[i]));
+  }
+}
+
+// Same noise as Dither(), added in double
+template <DitherMode Mode, typename Format>
+void DitherDouble(Format, const double* src, void* dst, size_t size,
+                  DitherState& state) {
+  for (size_t i = 0; i < size; ++i) {
+    double dither = NextDither<Mode>(state, i);
+    StoreInt(Format{}, dst, i, QuantizeDithered<Format>(src[i], dither));
+  }
+}
+
+template <typename Format>
+void FromDoubleDither(const double* src, void* dst, size_t size,
+                      DitherState& state) {
+  if constexpr (!IsDithered<Format>) {
+    FromDouble<Format>(src, dst, size);
+  } else {
+    switch (state.Mode) {
+      case DitherMode::None:
+        return DitherDouble<DitherMode::None>(Format{}, src, dst, size, state);
+      case DitherMode::Tpdf:
+        return DitherDouble<DitherMode::Tpdf>(Format{}, src, dst, size, state);
+      case DitherMode::Shaped:
+        return DitherDouble<DitherMode::Shaped>(Format{}, src, dst, size,
+                                                state);
+    }
+  }
+}
+
+
+// Instantiated at the end of each tier's translation unit,
+// once all of its vector kernels are visible
+template <CpuTier Tier>
+constexpr KernelTable MakeKernelTable() {
+  KernelTable table{Tier, Mix, Gain, Peak};
+
+#define CONVGEN(name, size, ...)                                   \
+  table.Converters[ASIOST##name] = {ToFloat<__VA_ARGS__>,          \
+                                    FromFloat<__VA_ARGS__>,        \
+                                    size,                          \
+                                    FromFloatDither<__VA_ARGS__>,  \
+                                    ToFloatGain<__VA_ARGS__>,      \
+                                    FromFloatGain<__VA_ARGS__>,    \
+                                    ToDouble<__VA_ARGS__>,         \
+                                    FromDouble<__VA_ARGS__>,       \
+                                    FromDoubleDither<__VA_ARGS__>};
+
+  CONVGEN(Int16LSB, 2, IntFormat<int16_t, 16, !IsLittleEndian>);
+  CONVGEN(Int16MSB, 2, IntFormat<int16_t, 16, IsLittleEndian>);
+  CONVGEN(Int24LSB, 3, Int24Format<!IsLittleEndian>);
+  CONVGEN(Int24MSB, 3, Int24Format<IsLittleEndian>);
+  CONVGEN(Int32LSB, 4, IntFormat<int32_t, 32, !IsLittleEndian>);
+  CONVGEN(Int32MSB, 4, IntFormat<int32_t, 32, IsLittleEndian>);
+  CONVGEN(Int32LSB16, 4, IntFormat<int32_t, 16, !IsLittleEndian>);
+  CONVGEN(Int32LSB18, 4, IntFormat<int32_t, 18, !IsLittleEndian>);
+  CONVGEN(Int32LSB20, 4, IntFormat<int32_t, 20, !IsLittleEndian>);
+  CONVGEN(Int32LSB24, 4, IntFormat<int32_t, 24, !IsLittleEndian>);
+  CONVGEN(Int32MSB16, 4, IntFormat<int32_t, 16, IsLittleEndian>);
+  CONVGEN(Int32MSB18, 4, IntFormat<int32_t, 18, IsLittleEndian>);
+  CONVGEN(Int32MSB20, 4, IntFormat<int32_t, 20, IsLittleEndian>);
+  CONVGEN(Int32MSB24, 4, IntFormat<int32_t, 24, IsLittleEndian>);
+  CONVGEN(Float32LSB, 4, FloatFormat<float, !IsLittleEndian>);
+  CONVGEN(Float32MSB, 4, FloatFormat<float, IsLittleEndian>);
+  CONVGEN(Float64LSB, 8, FloatFormat<double, !IsLittleEndian>);
+  CONVGEN(Float64MSB, 8, FloatFormat<double, IsLittleEndian>);
+
+
+#undef CONVGEN
+
+  return table;
+}
+
+}  // namespace
+
+// Defined by the tier translation units of the build, see Kernels.cpp
+extern const KernelTable ScalarKernels;
+extern const KernelTable Sse2Kernels;
+extern const KernelTable Avx2Kernels;
+extern const KernelTable Avx512Kernels;
+extern const KernelTable NeonKernels;
+
+}  // namespace Helpers
+}  // namespace GigOn
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "Aligned.hpp"
+
+namespace GigOn {
+namespace Helpers {
+
+// Bounded multi-producer multi-consumer queue (D. Vyukov's design).
+// Push() and Pop() never block or allocate, so they are safe to call on
+// the driver's thread. Every cell carries a sequence number telling
+// whether it is ready to be written or read on the current lap
+template <typename T, size_t Capacity>
+class LockFreeQueue final {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+  static_assert(std::is_trivially_copyable_v<T>,
+                "T is copied on the driver's thread");
+
+  struct Cell {
+    std::atomic<size_t> Sequence;
+    T Value;
+  };
+
+  std::array<Cell, Capacity> Cells;
+
+  // Producers and consumers spin on different cache lines
+  alignas(CacheLineSize) std::atomic<size_t> Tail = 0;
+  alignas(CacheLineSize) std::atomic<size_t> Head = 0;
+
+ public:
+  LockFreeQueue() {
+    for (size_t i = 0; i < Capacity; ++i)
+      Cells[i].Sequence.store(i, std::memory_order_relaxed);
+  }
+
+  LockFreeQueue(const LockFreeQueue&) = delete;
+  LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+  // Returns false if the queue is full
+  bool Push(const T& value) noexcept {
+    size_t pos = Tail.load(std::memory_order_relaxed);
+
+    while (true) {
+      auto& cell = Cells[pos & (Capacity - 1)];
+      size_t seq = cell.Sequence.load(std::memory_order_acquire);
+      auto diff = intptr_t(seq) - intptr_t(pos);
+
+      if (diff == 0) {
+        if (Tail.compare_exchange_weak(pos, pos + 1,
+                                       std::memory_order_relaxed)) {
+          cell.Value = value;
+          cell.Sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = Tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Returns false if the queue is empty
+  bool Pop(T& value) noexcept {
+    size_t pos = Head.load(std::memory_order_relaxed);
+
+    while (true) {
+      auto& cell = Cells[pos & (Capacity - 1)];
+      size_t seq = cell.Sequence.load(std::memory_order_acquire);
+      auto diff = intptr_t(seq) - intptr_t(pos + 1);
+
+      if (diff == 0) {
+        if (Head.compare_exchange_weak(pos, pos + 1,
+                                       std::memory_order_relaxed)) {
+          value = cell.Value;
+          cell.Sequence.store(pos + Capacity, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = Head.load(std::memory_order_relaxed);
+      }
+    }
+  }
+};
+
+}  // namespace Helpers
+}  // namespace GigOn
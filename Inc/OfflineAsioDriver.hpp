@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AsioDriver.hpp"
+#include "WavFile.hpp"
+
+namespace GigOn {
+
+// File-driven driver that renders as fast as the host can process.
+// Input channels are the channels of the input files in order,
+// output channels are split between the output files in order.
+// Start() runs buffer switches on a worker thread until the inputs
+// (plus the tail) are exhausted; Wait() blocks until then. The timeline
+// is virtual: sample position and system time advance by exactly one
+// buffer period per switch, so time-based host logic behaves as in real
+// time while running much faster
+class OfflineAsioDriver final : public IAsioDriver {
+ public:
+  static constexpr auto Name = "GigOn Offline";
+
+  struct OutputFile {
+    std::string Path;
+    size_t NumChannels = 2;
+  };
+
+  struct Config {
+    std::vector<std::string> InputFiles;
+    std::vector<OutputFile> OutputFiles;
+
+    ASIOSampleType SampleType = ASIOSTInt32LSB;
+
+    // Used when there are no input files
+    ASIOSampleRate SampleRate = 48000;
+
+    // Rendered after the longest input, e.g. for reverb tails.
+    // With no input files this is the whole render length
+    size_t TailFrames = 0;
+
+    struct {
+      size_t MinSize = 16;
+      size_t MaxSize = 8192;
+      size_t PrefSize = 512;
+      size_t Granularity = 1;
+    } BufferInfo;
+  };
+
+  struct Stats {
+    size_t RenderedFrames = 0;
+    std::chrono::nanoseconds Elapsed{0};
+
+    // Audio duration over wall-clock time spent rendering
+    double GetRealtimeFactor(ASIOSampleRate sampleRate) const;
+  };
+
+ private:
+  struct Channel {
+    bool IsInput = false;
+    long Number = 0;
+    std::vector<uint8_t> Storage;
+    void* Buffers[2] = {nullptr, nullptr};
+  };
+
+  Config Conf;
+
+  std::vector<std::unique_ptr<WavReader>> Readers;
+  std::vector<std::unique_ptr<WavWriter>> Writers;
+
+  size_t NumInputs = 0;
+  size_t NumOutputs = 0;
+  size_t TotalFrames = 0;
+
+  // Active buffer per device channel, nullptr if inactive
+  std::vector<Channel*> InputMap;
+  std::vector<Channel*> OutputMap;
+  std::vector<std::unique_ptr<Channel>> Channels;
+
+  std::vector<float> Interleaved;
+  std::vector<float> Planar;
+
+  ASIOCallbacks* Callbacks = nullptr;
+  ASIOTime Time{};
+  bool TimeInfoMode = false;
+
+  size_t BufferSize = 0;
+  long Toggle = 0;
+
+  std::atomic<uint64_t> SamplePosition = 0;
+  std::atomic<int64_t> SystemTime = 0;
+
+  std::thread Worker;
+  std::atomic<bool> Running = false;
+
+  std::mutex StateMutex;
+  std::condition_variable StateChanged;
+  bool Finished = false;
+  std::exception_ptr Error;
+  Stats RenderStats;
+
+ public:
+  // Opens all the files, throws if any of them can't be used
+  OfflineAsioDriver(const Config& config);
+  ~OfflineAsioDriver();
+
+  OfflineAsioDriver(const OfflineAsioDriver&) = delete;
+  OfflineAsioDriver& operator=(const OfflineAsioDriver&) = delete;
+
+  OfflineAsioDriver(OfflineAsioDriver&&) = delete;
+  OfflineAsioDriver& operator=(OfflineAsioDriver&&) = delete;
+
+  // Blocks until the render started by Start() is complete, rethrows file errors.
+  // Output files are finalized by then
+  Stats Wait();
+  bool IsFinished();
+
+  ASIOError Init(ASIODriverInfo* info) noexcept override;
+  ASIOError Exit() noexcept override;
+
+  ASIOError Start() noexcept override;
+  ASIOError Stop() noexcept override;
+
+  ASIOError GetChannels(long* numInputs, long* numOutputs) noexcept override;
+  ASIOError GetLatencies(long* inputLatency,
+                         long* outputLatency) noexcept override;
+  ASIOError GetBufferSize(long* minSize, long* maxSize, long* prefSize,
+                          long* granularity) noexcept override;
+
+  ASIOError CanSampleRate(ASIOSampleRate sampleRate) noexcept override;
+  ASIOError GetSampleRate(ASIOSampleRate* sampleRate) noexcept override;
+  ASIOError SetSampleRate(ASIOSampleRate sampleRate) noexcept override;
+
+  ASIOError GetSamplePosition(ASIOSamples* samplePos,
+                              ASIOTimeStamp* timeStamp) noexcept override;
+  ASIOError GetChannelInfo(ASIOChannelInfo* info) noexcept override;
+
+  ASIOError CreateBuffers(ASIOBufferInfo* bufferInfos, long numChannels,
+                          long bufferSize,
+                          ASIOCallbacks* callbacks) noexcept override;
+  ASIOError DisposeBuffers() noexcept override;
+
+  ASIOError OutputReady() noexcept override;
+  ASIOError Future(long selector, void* opt) noexcept override;
+
+ private:
+  void RenderLoop();
+  void Render();
+
+  void ReadInputs(long index);
+  void WriteOutputs(long index, size_t nFrames);
+
+  void Finish(std::exception_ptr error);
+};
+
+}  // namespace GigOn
@@ -0,0 +1,40 @@
+#pragma once
+
+namespace GigOn {
+namespace Helpers {
+
+// Marks the current thread as running real-time code while the scope
+// is alive. Scopes nest. With GIGON_RT_CHECKS defined, any heap
+// allocation or deallocation inside a scope aborts the process, as does
+// taking a pthread mutex on platforms where it can be intercepted.
+// Without it the scope compiles to nothing
+#ifdef GIGON_RT_CHECKS
+
+class RtScope final {
+ public:
+  RtScope() noexcept;
+  ~RtScope();
+
+  RtScope(const RtScope&) = delete;
+  RtScope& operator=(const RtScope&) = delete;
+};
+
+bool InRtScope() noexcept;
+[[noreturn]] void RtViolation(const char* what) noexcept;
+
+#else
+
+class RtScope final {
+ public:
+  RtScope() noexcept {}
+
+  RtScope(const RtScope&) = delete;
+  RtScope& operator=(const RtScope&) = delete;
+};
+
+inline bool InRtScope() noexcept { return false; }
+
+#endif
+
+}  // namespace Helpers
+}  // namespace GigOn
@@ -0,0 +1,131 @@
+#pragma once
+
+// asiosys needs to be included first
+// clang-format off
+#include "asiosys.h"
+#include "asio.h"
+// clang-format on
+
+#include <cstddef>
+#include <cstdint>
+
+namespace GigOn {
+namespace Helpers {
+
+// Noise added before float samples are rounded to an integer format
+enum class DitherMode {
+  None,    // Plain rounding
+  Tpdf,    // Triangular PDF, +-1 LSB, white
+  Shaped,  // Triangular PDF, +-1 LSB, first-order high-pass spectrum
+};
+
+// Per-channel state of the dithered output stage. The noise comes from
+// Lanes independent xorshift32 generators, sample i of a buffer draws
+// from generator i % Lanes. The vector kernels fill a whole register
+// from them at once and every CPU tier produces the same samples
+struct DitherState {
+  static constexpr size_t Lanes = 16;
+
+  DitherMode Mode = DitherMode::Tpdf;
+  uint32_t Random[Lanes] = {};
+  float Last = 0;  // Previous uniform draw, DitherMode::Shaped only
+
+  explicit DitherState(DitherMode mode = DitherMode::Tpdf, uint32_t seed = 1);
+};
+
+// Peak and RMS of the samples that went through the fused kernels,
+// accumulated until Reset(). Squares are summed in Lanes partial sums,
+// sample i of a call adding to sum i % Lanes, so every CPU tier gets
+// the same result
+struct MeterState {
+  static constexpr size_t Lanes = 16;
+
+  float Peak = 0;
+  float Squares[Lanes] = {};
+  size_t Count = 0;
+
+  float GetRms() const;
+  void Reset() { *this = {}; }
+};
+
+// Linear gain ramp of a channel. SetTarget() starts a new ramp
+// from the current gain, the fused kernels advance it
+struct GainRamp {
+  float Gain = 1;
+  float Target = 1;
+  float Step = 0;        // Per sample
+  size_t Remaining = 0;  // Samples until Target is reached
+
+  explicit GainRamp(float gain = 1) : Gain{gain}, Target{gain} {}
+
+  // Reaches target after length samples, at once if length is 0
+  void SetTarget(float target, size_t length);
+};
+
+// Whole-buffer conversion between an ASIO sample format
+// and normalized host floats
+struct SampleConverter {
+  using ToFloatFn = void (*)(const void* src, float* dst, size_t size);
+  using FromFloatFn = void (*)(const float* src, void* dst, size_t size);
+  using FromFloatDitherFn = void (*)(const float* src, void* dst, size_t size,
+                                     DitherState& state);
+  using ToFloatGainFn = void (*)(const void* src, float* dst, size_t size,
+                                 float gain, float step, MeterState& meter);
+  using FromFloatGainFn = void (*)(const float* src, void* dst, size_t size,
+                                   float gain, float step, MeterState& meter,
+                                   DitherState& dither);
+  using ToDoubleFn = void (*)(const void* src, double* dst, size_t size);
+  using FromDoubleFn = void (*)(const double* src, void* dst, size_t size);
+  using FromDoubleDitherFn = void (*)(const double* src, void* dst,
+                                      size_t size, DitherState& state);
+
+  ToFloatFn ToFloat = nullptr;
+  FromFloatFn FromFloat = nullptr;
+  size_t SampleSize = 0;
+
+  // Output stage for integer formats of up to 24 bits: adds dither in
+  // LSBs, saturates and rounds to the nearest step. Wider and float
+  // formats have nothing to dither, this is FromFloat for them
+  FromFloatDitherFn FromFloatDither = nullptr;
+
+  // Fused stages, one read and one write per sample. Sample i is
+  // multiplied by gain + step * (i + 1) on the float side and metered
+  // there, the output one then goes on like FromFloatDither.
+  // ConvertInput() and ConvertOutput() drive them with a GainRamp
+  ToFloatGainFn ToFloatGain = nullptr;
+  FromFloatGainFn FromFloatGain = nullptr;
+
+  // Same as ToFloat, FromFloat and FromFloatDither for double host
+  // samples, for double-precision processing. 64-bit float formats are
+  // copied, integers are scaled without going through float
+  ToDoubleFn ToDouble = nullptr;
+  FromDoubleFn FromDouble = nullptr;
+  FromDoubleDitherFn FromDoubleDither = nullptr;
+};
+
+// True for the host's own float layout, which needs no conversion.
+// Such buffers can be handed to float processing code in place
+bool IsNativeFloat(ASIOSampleType type);
+
+// Same for the host's double layout
+bool IsNativeDouble(ASIOSampleType type);
+
+// Size of a single sample in bytes, 0 for unknown formats
+size_t GetSampleSize(ASIOSampleType type);
+
+// Returns nullptr if the format is not supported.
+// Converters are static, so the pointer may be cached.
+// They come from the kernel table bound by GetKernels()
+const SampleConverter* GetSampleConverter(ASIOSampleType type);
+
+// Driver buffer -> float with the gain ramp applied and metered
+void ConvertInput(const SampleConverter& converter, const void* src,
+                  float* dst, size_t size, GainRamp& gain, MeterState& meter);
+
+// Float -> driver buffer with the gain ramp applied, metered and dithered
+void ConvertOutput(const SampleConverter& converter, const float* src,
+                   void* dst, size_t size, GainRamp& gain, MeterState& meter,
+                   DitherState& dither);
+
+}  // namespace Helpers
+}  // namespace GigOn
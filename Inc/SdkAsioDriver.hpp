@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "AsioDriver.hpp"
+
+namespace GigOn {
+
+// Installed ASIO driver, loaded through the SDK's driver list.
+// Windows only. The SDK keeps a single current driver,
+// so only one instance may exist at a time
+class SdkAsioDriver final : public IAsioDriver {
+ public:
+  SdkAsioDriver(const std::string& driverName);
+  ~SdkAsioDriver();
+
+  SdkAsioDriver(const SdkAsioDriver&) = delete;
+  SdkAsioDriver& operator=(const SdkAsioDriver&) = delete;
+
+  SdkAsioDriver(SdkAsioDriver&&) = delete;
+  SdkAsioDriver& operator=(SdkAsioDriver&&) = delete;
+
+  static std::vector<std::string> GetDriverNames(size_t maxNames);
+
+  ASIOError Init(ASIODriverInfo* info) noexcept override;
+  ASIOError Exit() noexcept override;
+
+  ASIOError Start() noexcept override;
+  ASIOError Stop() noexcept override;
+
+  ASIOError GetChannels(long* numInputs, long* numOutputs) noexcept override;
+  ASIOError GetLatencies(long* inputLatency,
+                         long* outputLatency) noexcept override;
+  ASIOError GetBufferSize(long* minSize, long* maxSize, long* prefSize,
+                          long* granularity) noexcept override;
+
+  ASIOError CanSampleRate(ASIOSampleRate sampleRate) noexcept override;
+  ASIOError GetSampleRate(ASIOSampleRate* sampleRate) noexcept override;
+  ASIOError SetSampleRate(ASIOSampleRate sampleRate) noexcept override;
+
+  ASIOError GetSamplePosition(ASIOSamples* samplePos,
+                              ASIOTimeStamp* timeStamp) noexcept override;
+  ASIOError GetChannelInfo(ASIOChannelInfo* info) noexcept override;
+
+  ASIOError CreateBuffers(ASIOBufferInfo* bufferInfos, long numChannels,
+                          long bufferSize,
+                          ASIOCallbacks* callbacks) noexcept override;
+  ASIOError DisposeBuffers() noexcept override;
+
+  ASIOError OutputReady() noexcept override;
+  ASIOError Future(long selector, void* opt) noexcept override;
+};
+
+}  // namespace GigOn
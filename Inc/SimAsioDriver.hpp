@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "AsioDriver.hpp"
+
+namespace GigOn {
+
+// Software ASIO driver modelled after the SDK's asiosample: a timer
+// thread calls bufferSwitch() once per buffer period, toggling the
+// double-buffer halves and filling the inputs with test tones.
+// Needs no hardware, so the whole host path runs on any platform
+class SimAsioDriver final : public IAsioDriver {
+ public:
+  static constexpr auto Name = "GigOn Simulator";
+
+  struct Config {
+    size_t NumInputs = 2;
+    size_t NumOutputs = 2;
+    ASIOSampleType SampleType = ASIOSTInt32LSB;
+    // Initial rate, see SetSampleRate()
+    ASIOSampleRate SampleRate = 48000;
+
+    struct {
+      size_t MinSize = 16;
+      size_t MaxSize = 4096;
+      size_t PrefSize = 256;
+      size_t Granularity = 16;
+    } BufferInfo;
+
+    // Reported by GetLatencies() on top of the buffer size
+    size_t ExtraLatency = 0;
+
+    // Each switch is delayed by a random amount up to this value.
+    // The period grid itself does not drift
+    std::chrono::microseconds Jitter{0};
+    uint32_t Seed = 1;
+
+    // When false, switches follow each other as fast as the host
+    // handles them, which is what benchmarks want
+    bool Paced = true;
+
+    // Feed outputs back to the inputs instead of generating test tones.
+    // The loop is delayed by the reported input + output latency, so
+    // a measured round trip matches GetLatencies()
+    bool Loopback = false;
+
+    bool SupportsOutputReady = true;
+  };
+
+ private:
+  struct Channel {
+    bool IsInput = false;
+    long Number = 0;
+    std::vector<uint8_t> Storage;
+    void* Buffers[2] = {nullptr, nullptr};
+  };
+
+  Config Conf;
+
+  std::vector<Channel> Channels;
+  std::vector<size_t> LoopbackSources;
+
+  // Per-channel delay lines of LoopbackDelay samples
+  std::vector<std::vector<uint8_t>> LoopbackLines;
+  size_t LoopbackDelay = 0;
+  size_t LoopbackPos = 0;
+
+  std::vector<float> Scratch;
+  std::vector<double> Phases;
+
+  ASIOCallbacks* Callbacks = nullptr;
+  ASIOTime Time{};
+  bool TimeInfoMode = false;
+
+  size_t BufferSize = 0;
+  long Toggle = 0;
+
+  // Set by the host on the control thread, taken over by the
+  // timer thread at the next buffer switch
+  std::atomic<ASIOSampleRate> RequestedRate;
+  ASIOSampleRate SampleRate;
+
+  std::atomic<uint64_t> SamplePosition = 0;
+  std::atomic<int64_t> SystemTime = 0;
+
+  std::thread Timer;
+  std::atomic<bool> Running = false;
+  std::minstd_rand Random;
+
+ public:
+  SimAsioDriver();
+  SimAsioDriver(const Config& config);
+  ~SimAsioDriver();
+
+  SimAsioDriver(const SimAsioDriver&) = delete;
+  SimAsioDriver& operator=(const SimAsioDriver&) = delete;
+
+  SimAsioDriver(SimAsioDriver&&) = delete;
+  SimAsioDriver& operator=(SimAsioDriver&&) = delete;
+
+  const Config& GetConfig() const;
+
+  // Sends a message to the host the way hardware events do, e.g.
+  // kAsioResetRequest. kAsioBufferSizeChange also changes the preferred
+  // buffer size. Returns the host's answer, 0 if there are no buffers
+  long SendMessage(long selector, long value);
+
+  ASIOError Init(ASIODriverInfo* info) noexcept override;
+  ASIOError Exit() noexcept override;
+
+  ASIOError Start() noexcept override;
+  ASIOError Stop() noexcept override;
+
+  ASIOError GetChannels(long* numInputs, long* numOutputs) noexcept override;
+  ASIOError GetLatencies(long* inputLatency,
+                         long* outputLatency) noexcept override;
+  ASIOError GetBufferSize(long* minSize, long* maxSize, long* prefSize,
+                          long* granularity) noexcept override;
+
+  ASIOError CanSampleRate(ASIOSampleRate sampleRate) noexcept override;
+  ASIOError GetSampleRate(ASIOSampleRate* sampleRate) noexcept override;
+  ASIOError SetSampleRate(ASIOSampleRate sampleRate) noexcept override;
+
+  ASIOError GetSamplePosition(ASIOSamples* samplePos,
+                              ASIOTimeStamp* timeStamp) noexcept override;
+  ASIOError GetChannelInfo(ASIOChannelInfo* info) noexcept override;
+
+  ASIOError CreateBuffers(ASIOBufferInfo* bufferInfos, long numChannels,
+                          long bufferSize,
+                          ASIOCallbacks* callbacks) noexcept override;
+  ASIOError DisposeBuffers() noexcept override;
+
+  ASIOError OutputReady() noexcept override;
+  ASIOError Future(long selector, void* opt) noexcept override;
+
+ private:
+  std::chrono::nanoseconds GetPeriod() const;
+
+  void TimerLoop();
+  void BufferSwitch();
+  void ApplySampleRate();
+
+  void GenerateInputs(long index);
+  void LoopbackInputs(long index);
+  void LoopbackOutputs(long index);
+};
+
+}  // namespace GigOn
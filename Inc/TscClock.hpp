@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(_MSC_VER) || (defined(_WIN32) && defined(__clang__))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace GigOn {
+namespace Helpers {
+
+// Cheapest monotonic tick counter of the platform: the time stamp counter
+// on x86 (assumed invariant, as on every CPU of the last decade), the
+// virtual counter on AArch64, steady_clock nanoseconds elsewhere.
+// Ticks are converted with the rate calibrated against steady_clock
+struct TscClock final {
+  static uint64_t Now() noexcept {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+    defined(_M_IX86)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+#endif
+  }
+
+  // Calibrated once on the first call, which takes a few milliseconds.
+  // Call it from a non real-time thread before relying on it
+  static double GetTicksPerNs();
+
+  static double ToNs(uint64_t ticks) { return ticks / GetTicksPerNs(); }
+};
+
+}  // namespace Helpers
+}  // namespace GigOn
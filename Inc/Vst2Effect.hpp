@@ -1,7 +1,9 @@
 #include <errno.h>
 #include <windows.h>
 
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -11,36 +13,29 @@
 #include <vector>
 
 #include "Helpers.hpp"
+#include "VstEventQueue.hpp"
+#include "VstProcessBuffer.hpp"
 #include "aeffectx.h"
 
 namespace GigOn {
 
-class VstProcessBuffer {
-public:
-  using VstBufferT = float**;
-  using CVstBufferT = const float* const*;
-private:
-  Helpers::Moveable<size_t> BlockSize;
-  Helpers::Moveable<size_t> NChannels;
-
-  std::vector<float> Buffer{};
-  std::vector<float*> Pointers{};
-
- public:
-  VstProcessBuffer(size_t blockSize, size_t nChannels);
-
-  VstBufferT GetVstBuffers();
-  CVstBufferT GetVstBuffers() const;
-
-  float* GetBufferByChannel(size_t channel);
-  const float* GetBufferByChannel(size_t channel) const;
-
-  size_t GetBlockSize() const;
-  size_t GetChannels() const;
-};
-
 // Vst2 AEffect* wrapper
 class Vst2Effect final {
+ public:
+  // Sample type of the process calls, see Configure()
+  enum class Precision { Single, Double };
+
+  // Errors of the process calls. They never throw, a call with an
+  // error silences the outputs and sets these flags instead,
+  // see TakeProcessErrors()
+  enum class ProcessError : uint32_t {
+    NotRunning = 1 << 0,
+    PrecisionMismatch = 1 << 1,
+    BadInputs = 1 << 2,
+    BadOutputs = 1 << 3,
+  };
+
+ private:
   static constexpr auto Label = "Vst2.4 effect wrapper";
   static constexpr size_t InfoStringSize = 256;
   static constexpr auto MainEntryName = "VSTPluginMain";
@@ -58,23 +53,70 @@ class Vst2Effect final {
     std::string Product;
     size_t NumInputs = 0;
     size_t NumOutputs = 0;
+    bool CanProcessDouble = false;
+    bool IsSynth = false;
   } Info;
 
   Helpers::Moveable<bool> Configured{false};
   Helpers::Moveable<bool> Started{false};
 
   size_t BlockSize = 0;
+  Precision ProcessPrecision = Precision::Single;
   std::unique_ptr<AEffect, EffectDeleter> Effect{};
 
+  // Delivered with effProcessEvents ahead of every process call
+  std::unique_ptr<VstEventQueue> Events{};
+
+  // ProcessError flags, behind a pointer to keep the effect movable
+  std::unique_ptr<std::atomic<uint32_t>> ProcessErrors{};
+
  public:
   Vst2Effect(const Helpers::DllLoader& dll);
-  void Configure(float sampleRate, VstInt32 blockSize);
+
+  // Precision::Double is granted only if the plugin can process doubles,
+  // otherwise it falls back to single. GetPrecision() tells which one
+  // the plugin was set to
+  void Configure(float sampleRate, VstInt32 blockSize,
+                 Precision precision = Precision::Single);
 
   void Start();
   void Stop();
 
-  void Process(const VstProcessBuffer& input, VstProcessBuffer& output);
+  // The overload has to match GetPrecision(). Inputs and outputs have
+  // the same block size, anything up to GetBlockSize()
+  void Process(const VstProcessBuffer& input,
+               VstProcessBuffer& output) noexcept;
+  void Process(const VstProcessDoubleBuffer& input,
+               VstProcessDoubleBuffer& output) noexcept;
+
+  // Processes caller-owned memory in place, no copies
+  void Process(const VstProcessView& input,
+               const VstProcessView& output) noexcept;
+  void Process(const VstProcessDoubleView& input,
+               const VstProcessDoubleView& output) noexcept;
+
+  // Returns ProcessError flags raised since the previous call
+  // and clears them
+  uint32_t TakeProcessErrors() noexcept;
+  static bool HasProcessError(uint32_t errors, ProcessError error);
+
+  // Queues a MIDI message for the process call covering its position,
+  // see GetSamplePosition(). Safe from any thread, never blocks.
+  // Returns false if the queue is full
+  bool SendMidi(const MidiEvent& event) noexcept;
+
+  // Frame the next process call starts at
+  int64_t GetSamplePosition() const noexcept;
+
   EffectInfo GetInfo() const;
+  Precision GetPrecision() const;
+
+  // Largest block a process call takes, as configured
+  size_t GetBlockSize() const;
+
+  // Processing delay reported by the plugin, in samples.
+  // Read live, as plugins may change it (see audioMasterIOChanged)
+  size_t GetInitialDelay() const;
 
   Vst2Effect(const Vst2Effect&) = delete;
   Vst2Effect& operator=(const Vst2Effect&) = delete;
@@ -97,6 +139,18 @@ class Vst2Effect final {
 
   void SetSampleRateImpl(float rate);
   void SetBlockSizeImpl(VstInt32 size);
+  void SetPrecisionImpl(Precision precision);
+
+  void ProcessEventsImpl(VstInt32 frames) noexcept;
+
+  // False if the call can't be processed: the error is raised
+  // and the outputs are silenced
+  template <typename T>
+  bool CheckBuffers(const BasicVstProcessView<T>& input,
+                    const BasicVstProcessView<T>& output,
+                    Precision precision) noexcept;
+
+  void RaiseProcessError(ProcessError error) noexcept;
 
   void StartImpl();
   void StopImpl();
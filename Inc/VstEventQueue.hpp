@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "LockFreeQueue.hpp"
+#include "aeffectx.h"
+
+namespace GigOn {
+
+// Short MIDI message for the frame at Position. Positions count the
+// frames the plugin has processed, see VstEventQueue::GetPosition()
+struct MidiEvent {
+  int64_t Position = 0;
+  uint8_t Data[3] = {};
+};
+
+// Events on their way to one plugin. Producers Push() from any thread,
+// the processing thread calls Collect() once per process call and gets
+// the events due in that block as VstEvents, deltaFrames relative to
+// the block start. Nothing allocates after construction
+class VstEventQueue final {
+ public:
+  // Events waiting, both in the queue and due in later blocks
+  static constexpr size_t Capacity = 1024;
+
+ private:
+  Helpers::LockFreeQueue<MidiEvent, Capacity> Incoming;
+
+  // Taken from Incoming but due after the last collected block
+  std::array<MidiEvent, Capacity> Pending;
+  size_t NPending = 0;
+
+  std::array<VstMidiEvent, Capacity> MidiEvents;
+
+  // VstEvents ends in a variable-length pointer array
+  struct {
+    VstEvents Header;
+    VstEvent* More[Capacity - 2];
+  } Events;
+
+  std::atomic<int64_t> Position = 0;
+
+ public:
+  VstEventQueue();
+
+  VstEventQueue(const VstEventQueue&) = delete;
+  VstEventQueue& operator=(const VstEventQueue&) = delete;
+
+  // Returns false if the queue is full
+  bool Push(const MidiEvent& event) noexcept;
+
+  // Events due in the next frames frames, ordered by deltaFrames.
+  // Late ones are delivered at 0. Advances the position by frames.
+  // Valid until the next call
+  VstEvents* Collect(size_t frames) noexcept;
+
+  // First frame of the next block. Events pushed for it or any later
+  // frame are delivered sample-accurately
+  int64_t GetPosition() const noexcept;
+};
+
+}  // namespace GigOn
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "Aligned.hpp"
+#include "BufferArena.hpp"
+
+namespace GigOn {
+
+// Channel buffers of a process call. T is float for processReplacing()
+// and double for processDoubleReplacing().
+// Every channel starts on a cache line and is followed by at least
+// padding bytes of slack, so SIMD loops can use aligned loads and read
+// up to the end of the last cache line. The slack also keeps channels of
+// power-of-two blocks from landing in the same cache sets
+template <typename T>
+class BasicVstProcessBuffer {
+ public:
+  using VstBufferT = T**;
+  using CVstBufferT = const T* const*;
+
+  static constexpr size_t Alignment = Helpers::CacheLineSize;
+  static constexpr size_t DefaultPadding = Helpers::CacheLineSize;
+
+ private:
+  size_t BlockSize = 0;
+  size_t NChannels = 0;
+  size_t Stride = 0;
+
+  // Storage is either Buffer or a block of an arena
+  Helpers::AlignedVector<T, Alignment> Buffer{};
+  T* Storage = nullptr;
+  std::vector<T*> Pointers{};
+
+ public:
+  // padding is in bytes and rounded up to whole cache lines
+  BasicVstProcessBuffer(size_t blockSize, size_t nChannels,
+                        size_t padding = DefaultPadding);
+
+  // Channels live in a block of arena, which has to outlive the buffer
+  // or at least its next Reset()
+  BasicVstProcessBuffer(BufferArena& arena, size_t blockSize,
+                        size_t nChannels, size_t padding = DefaultPadding);
+
+  BasicVstProcessBuffer(const BasicVstProcessBuffer&) = delete;
+  BasicVstProcessBuffer& operator=(const BasicVstProcessBuffer&) = delete;
+
+  BasicVstProcessBuffer(BasicVstProcessBuffer&& other) noexcept;
+  BasicVstProcessBuffer& operator=(BasicVstProcessBuffer&& other) noexcept;
+
+  VstBufferT GetVstBuffers();
+  CVstBufferT GetVstBuffers() const;
+
+  T* GetBufferByChannel(size_t channel);
+  const T* GetBufferByChannel(size_t channel) const;
+
+  // Points the channel at external memory, e.g. a driver buffer, until
+  // ResetBufferByChannel(). It has to hold GetBlockSize() samples and
+  // has no alignment guarantees
+  void SetBufferByChannel(size_t channel, T* buffer);
+  void ResetBufferByChannel(size_t channel);
+
+  size_t GetBlockSize() const;
+  size_t GetChannels() const;
+
+  // Distance between the own channel buffers, in samples
+  size_t GetStride() const;
+};
+
+using VstProcessBuffer = BasicVstProcessBuffer<float>;
+using VstProcessDoubleBuffer = BasicVstProcessBuffer<double>;
+
+extern template class BasicVstProcessBuffer<float>;
+extern template class BasicVstProcessBuffer<double>;
+
+// Non-owning counterpart of BasicVstProcessBuffer over channel pointers
+// owned by the caller: driver buffers, ring buffers, another plugin's
+// outputs. Copies are shallow and cheap. The pointer array and the
+// samples have to outlive the view
+template <typename T>
+class BasicVstProcessView {
+ public:
+  using VstBufferT = T* const*;
+
+ private:
+  T* const* Channels = nullptr;
+  size_t BlockSize = 0;
+  size_t NChannels = 0;
+
+ public:
+  BasicVstProcessView() = default;
+
+  BasicVstProcessView(T* const* channels, size_t blockSize, size_t nChannels)
+      : Channels{channels}, BlockSize{blockSize}, NChannels{nChannels} {
+    assert(channels || nChannels == 0);
+  }
+
+  BasicVstProcessView(BasicVstProcessBuffer<T>& buffer)
+      : BasicVstProcessView{buffer.GetVstBuffers(), buffer.GetBlockSize(),
+                            buffer.GetChannels()} {}
+
+  VstBufferT GetVstBuffers() const { return Channels; }
+
+  T* GetBufferByChannel(size_t channel) const {
+    assert(channel < NChannels);
+    return Channels[channel];
+  }
+
+  size_t GetBlockSize() const { return BlockSize; }
+  size_t GetChannels() const { return NChannels; }
+
+  // Samples [offset, offset + size) of every channel. The shifted
+  // pointers are written to storage, which has to hold GetChannels()
+  // of them and outlive the slice
+  BasicVstProcessView Slice(size_t offset, size_t size, T** storage) const {
+    assert(offset + size <= BlockSize);
+    assert(storage || NChannels == 0);
+
+    for (size_t i = 0; i < NChannels; ++i) storage[i] = Channels[i] + offset;
+    return {storage, size, NChannels};
+  }
+};
+
+using VstProcessView = BasicVstProcessView<float>;
+using VstProcessDoubleView = BasicVstProcessView<double>;
+
+}  // namespace GigOn
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace GigOn {
+
+// Streaming reader for PCM (16/24/32 bit) and IEEE float (32/64 bit)
+// WAV files, including WAVE_FORMAT_EXTENSIBLE. Samples are returned
+// as interleaved normalized floats
+class WavReader final {
+  static constexpr auto Label = "WAV reader";
+
+  enum class Format { Pcm, Float };
+
+  std::ifstream File;
+  std::string Path;
+
+  Format SampleFormat = Format::Pcm;
+  size_t NumChannels = 0;
+  size_t BitsPerSample = 0;
+  size_t SampleRate = 0;
+  size_t NumFrames = 0;
+  size_t FramesLeft = 0;
+
+  std::vector<uint8_t> Raw;
+
+ public:
+  WavReader(const std::string& path);
+
+  // Reads up to nFrames frames, returns the number of frames read.
+  // dst must hold nFrames * GetChannels() floats
+  size_t Read(float* dst, size_t nFrames);
+
+  size_t GetChannels() const;
+  size_t GetSampleRate() const;
+  size_t GetFrames() const;
+
+ private:
+  void ParseHeader();
+  [[noreturn]] void Fail(const std::string& msg) const;
+};
+
+// Writes 32-bit float WAV files. Sizes in the header are
+// patched when the file is closed
+class WavWriter final {
+  static constexpr auto Label = "WAV writer";
+
+  std::ofstream File;
+  std::string Path;
+
+  size_t NumChannels = 0;
+  size_t NumFrames = 0;
+
+ public:
+  WavWriter(const std::string& path, size_t nChannels, size_t sampleRate);
+  ~WavWriter();
+
+  WavWriter(const WavWriter&) = delete;
+  WavWriter& operator=(const WavWriter&) = delete;
+
+  WavWriter(WavWriter&&) = default;
+  WavWriter& operator=(WavWriter&&) = default;
+
+  // src holds nFrames * GetChannels() interleaved floats
+  void Write(const float* src, size_t nFrames);
+  void Close();
+
+  size_t GetChannels() const;
+  size_t GetFrames() const;
+
+ private:
+  void WriteHeader(size_t sampleRate);
+  [[noreturn]] void Fail(const std::string& msg) const;
+};
+
+}  // namespace GigOn
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "HdrHistogram.hpp"
+#include "TscClock.hpp"
+
+namespace GigOn {
+namespace Helpers {
+
+// Times buffer switches against their deadline, the buffer period.
+// Durations are recorded as load, the fraction of the period spent in
+// the callback, into a lock-free histogram; a switch that takes longer
+// than the period is a miss. The driver thread records, any other thread
+// may take snapshots at any time
+class XrunMonitor final {
+ public:
+  // Load is stored in units of 1 / LoadScale of the period
+  static constexpr uint64_t LoadScale = 10000;
+
+  // Loads above are clamped, in periods
+  static constexpr uint64_t MaxLoad = 1000;
+
+  struct Snapshot {
+    uint64_t Switches = 0;
+    uint64_t Misses = 0;
+    uint64_t Overloads = 0;
+    double PeriodNs = 0;
+    HdrHistogram::Snapshot Load;
+
+    // Fraction of the period, 1.0 means the deadline was hit exactly
+    double GetLoadAtPercentile(double percentile) const;
+    double GetMaxLoad() const;
+    double GetMeanLoad() const;
+
+    // Statistics of the switches after earlier was taken
+    Snapshot Since(const Snapshot& earlier) const;
+  };
+
+  // Pairs Begin() with End() for the scope of a switch
+  class Scope final {
+    XrunMonitor* Monitor;
+    uint64_t Start;
+
+   public:
+    Scope(XrunMonitor* monitor) noexcept
+        : Monitor{monitor}, Start{monitor ? TscClock::Now() : 0} {}
+    ~Scope() {
+      if (Monitor) Monitor->Record(TscClock::Now() - Start);
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+  };
+
+ private:
+  HdrHistogram Histogram{MaxLoad * LoadScale};
+
+  // Configure() may run while the driver is switching
+  std::atomic<uint64_t> PeriodTicks = 0;
+  std::atomic<double> LoadPerTick = 0;
+  std::atomic<double> PeriodNs = 0;
+
+  std::atomic<uint64_t> Misses = 0;
+  std::atomic<uint64_t> Overloads = 0;
+
+ public:
+  XrunMonitor() = default;
+
+  XrunMonitor(const XrunMonitor&) = delete;
+  XrunMonitor& operator=(const XrunMonitor&) = delete;
+
+  // Calibrates the clock on first use
+  void Configure(size_t bufferSize, double sampleRate);
+
+  // Switch duration in TscClock ticks
+  void Record(uint64_t ticks) noexcept {
+    uint64_t period = PeriodTicks.load(std::memory_order_relaxed);
+    if (period == 0) return;
+
+    if (ticks > period)
+      Misses.store(Misses.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_relaxed);
+
+    Histogram.Record(
+        uint64_t(ticks * LoadPerTick.load(std::memory_order_relaxed)));
+  }
+
+  // Driver reported kAsioOverload
+  void RecordOverload() noexcept {
+    Overloads.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  Snapshot TakeSnapshot() const;
+};
+
+}  // namespace Helpers
+}  // namespace GigOn
@@ -1,6 +1,15 @@
 #include "AsioContext.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+
+#include "Kernels.hpp"
+#include "SimAsioDriver.hpp"
+
+#ifdef _WIN32
+#include "SdkAsioDriver.hpp"
+#endif
 
 #undef min
 #undef max
@@ -10,22 +19,21 @@
 
 namespace GigOn {
 
-const size_t ASIO_DRIVER_NAME_LEN = 32;
-
 AsioContext::Exception::Exception(const std::string& msg, ASIOError errorCode)
     : std::runtime_error{msg + ": " + Helpers::ASIOErrorToStr(errorCode)} {}
 AsioContext::Exception::~Exception() {}
 
-AsioDrivers& AsioContext::GetAsioDrivers() {
-  static AsioDrivers drivers{};
-  return drivers;
-}
-
 AsioContext::AsioContext() {
   AsioCallbacks.asioMessage = AsioMessageCallback;
-  AsioCallbacks.bufferSwitch = AsioBufferSwitchCallback;
-  AsioCallbacks.bufferSwitchTimeInfo = AsioBufferSwitchTimeInfoCallback;
+  AsioCallbacks.bufferSwitch = Dispatch<IBlockProcessor>::BufferSwitch;
+  AsioCallbacks.bufferSwitchTimeInfo =
+      Dispatch<IBlockProcessor>::BufferSwitchTimeInfo;
   AsioCallbacks.sampleRateDidChange = AsioSampleRateChangedCallback;
+
+  // Probe the CPU before any kernel runs on the driver thread
+  Helpers::GetKernels();
+
+  Supervisor = std::thread{&AsioContext::SupervisorLoop, this};
 }
 
 AsioContext& AsioContext::Get() {
@@ -34,46 +42,111 @@ AsioContext& AsioContext::Get() {
 }
 
 void AsioContext::LoadDriver(const std::string& driverName) {
+  std::lock_guard lock{ControlMutex};
+
   Expect(!Loaded, Msg::AlreadyLoaded);
 
-  std::string tmp = driverName;
+  if (driverName == SimAsioDriver::Name)
+    return LoadDriver(std::make_unique<SimAsioDriver>());
+
+#ifdef _WIN32
+  LoadDriver(std::make_unique<SdkAsioDriver>(driverName));
+#else
+  throw std::runtime_error("Failed to load driver \"" + driverName + "\"");
+#endif
+}
+
+void AsioContext::LoadDriver(AsioDriverT&& driver) {
+  std::lock_guard lock{ControlMutex};
 
-  if (!GetAsioDrivers().loadDriver(&tmp[0]))
-    throw std::runtime_error("Failed to load driver \"" + driverName + "\"");
+  Expect(!Loaded, Msg::AlreadyLoaded);
+  Expect(!!driver, Msg::NotLoaded);
 
+  Driver = std::move(driver);
   Loaded = true;
 }
 
 void AsioContext::InitDriver() {
+  std::lock_guard lock{ControlMutex};
+
   Expect(Loaded, Msg::NotLoaded);
   Expect(!Initialized, Msg::AlreadyLoaded);
 
-  ASIOError status = ASIOInit(&AsioInfo);
+  ASIOError status = Driver->Init(&AsioInfo);
   if (status != ASE_OK) throw Exception("Failed to init driver", status);
 
   DeviceInfo = GetDeviceInfoInternal();
-  PostOutput = ASIOOutputReady() == ASE_OK;
+  PostOutput = Driver->OutputReady() == ASE_OK;
+
+  // Driver may have lost OutputReady() support after a reset
+  if (HandlersSet) RebindDispatch(*this);
 
   Initialized = true;
 }
 
 void AsioContext::SetHandlers(ProcessorT&& proc, HandlerT&& handler) {
+  std::lock_guard lock{ControlMutex};
+  SetHandlers(Helpers::AsioChannelAdapter::Create(std::move(proc)),
+              std::move(handler));
+}
+
+void AsioContext::SetHandlers(BlockProcessorT&& proc, HandlerT&& handler) {
+  std::lock_guard lock{ControlMutex};
+
   Expect(Initialized, Msg::NotInit);
   Expect(!BuffersCreated, Msg::BuffersPresent);
 
   Processor = std::move(proc);
   Handler = std::move(handler);
+  BindDispatch(Processor.get());
 
   HandlersSet = true;
 }
 
+void AsioContext::SwapProcessor(ProcessorT&& proc) {
+  SwapProcessor(Helpers::AsioChannelAdapter::Create(std::move(proc)));
+}
+
+void AsioContext::SwapProcessor(BlockProcessorT&& proc) {
+  std::lock_guard lock{ControlMutex};
+
+  Expect(BuffersCreated, Msg::BuffersAbsent);
+  Expect(RebindDispatch == &RebindImpl<IBlockProcessor>,
+         Msg::DispatchMismatch);
+
+  PrepareProcessor(*proc);
+  Dispatch<IBlockProcessor>::Instance.store(proc.get());
+
+  RetireProcessor(std::move(proc));
+}
+
+void AsioContext::PrepareProcessor(IBlockProcessor& proc) {
+  proc.SetSampleRate(DeviceInfo.SampleRate);
+  proc.Configure(ActiveBuffersInfo.BufferSize, ActiveBuffersInfo.NumInput,
+                 ActiveBuffersInfo.NumOutput);
+}
+
+void AsioContext::RetireProcessor(BlockProcessorT&& next) {
+  Retired.push_back(std::move(Processor));
+  Processor = std::move(next);
+
+  // A flag rather than a request: a burst of swaps is reclaimed at once
+  // and never takes queue slots from the driver's requests
+  ReclaimPending.store(true, std::memory_order_release);
+  WakeSupervisor();
+}
+
 void AsioContext::CreateBuffers(const std::vector<ChannelId>& inputs,
                                 const std::vector<ChannelId>& outputs,
                                 size_t bufferSize) {
+  std::lock_guard lock{ControlMutex};
+
   Expect(HandlersSet, Msg::NoHandlersSet);
   Expect(!BuffersCreated, Msg::BuffersPresent);
 
-  CheckBufferSize(bufferSize);
+  CheckBufferSize(DeviceInfo, bufferSize);
+  CheckChannels(inputs, DeviceInfo.Inputs.size());
+  CheckChannels(outputs, DeviceInfo.Outputs.size());
 
   std::vector<ASIOBufferInfo> binfos(inputs.size() + outputs.size(),
                                      ASIOBufferInfo{});
@@ -94,88 +167,168 @@ void AsioContext::CreateBuffers(const std::vector<ChannelId>& inputs,
     binfos[i].buffers[1] = 0;
   }
 
-  ASIOError status = ASIOCreateBuffers(binfos.data(), binfos.size(), bufferSize,
-                                       &AsioCallbacks);
+  ActiveBuffersInfo.NumInput = inputs.size();
+  ActiveBuffersInfo.NumOutput = outputs.size();
+
+  AsioBufferInfos = std::move(binfos);
+  SetupBuffers(bufferSize);
+}
+
+void AsioContext::SetupBuffers(size_t bufferSize) {
+  // Buffer pointers are filled by the driver
+  for (auto& binfo : AsioBufferInfos) binfo.buffers[0] = binfo.buffers[1] = 0;
+
+  ASIOError status =
+      Driver->CreateBuffers(AsioBufferInfos.data(), AsioBufferInfos.size(),
+                            bufferSize, &AsioCallbacks);
   if (status != ASE_OK) throw Exception("ASIOCreateBuffers()", status);
 
   // Kalb line here
 
-  ActiveBuffersInfo.NumInput = inputs.size();
-  ActiveBuffersInfo.NumOutput = outputs.size();
   ActiveBuffersInfo.BufferSize = bufferSize;
 
-  AsioBufferInfos = std::move(binfos);
+  BuildBlocks(bufferSize);
+  Monitor.Configure(bufferSize, DeviceInfo.SampleRate);
+
+  PrepareProcessor(*Processor);
 
-  Processor->Configure(bufferSize, inputs.size(), outputs.size());
+  // A failed reconfiguration leaves processing suspended
+  ResumeProcessing();
 
   BuffersCreated = true;
 }
 
 void AsioContext::Start() {
+  std::lock_guard lock{ControlMutex};
+
   Expect(BuffersCreated, Msg::BuffersAbsent);
   Expect(!Started, Msg::AlreadyRunning);
 
-  ASIOError status = ASIOStart();
+  ASIOError status = Driver->Start();
   if (status != ASE_OK) throw Exception("ASIOStart()", status);
 
   Started = true;
 }
 
 void AsioContext::Stop() {
+  std::lock_guard lock{ControlMutex};
+
   Expect(Started, Msg::NotRunning);
 
-  ASIOError status = ASIOStop();
+  ASIOError status = Driver->Stop();
   if (status != ASE_OK) throw Exception("ASIOStop()", status);
 
   Started = false;
 }
 
 void AsioContext::DisposeBuffers() {
+  std::lock_guard lock{ControlMutex};
+
   Expect(BuffersCreated, Msg::BuffersAbsent);
   Expect(!Started, Msg::AlreadyRunning);
 
-  ASIOError status = ASIODisposeBuffers();
+  ASIOError status = Driver->DisposeBuffers();
   if (status != ASE_OK) throw Exception("ASIODisposeBuffers()", status);
 
+  // No switches anymore, nothing to wait for
+  Retired.clear();
+
   BuffersCreated = false;
 }
 
 void AsioContext::DeInitDriver() {
+  std::lock_guard lock{ControlMutex};
+
   Expect(Initialized, Msg::NotInit);
   Expect(!BuffersCreated, Msg::BuffersPresent);
 
-  ASIOError status = ASIOExit();
+  ASIOError status = Driver->Exit();
   if (status != ASE_OK) throw Exception("ASIOExit()", status);
 
   Initialized = false;
 }
 
 void AsioContext::UnloadDriver() {
+  std::lock_guard lock{ControlMutex};
+
   Expect(Loaded, Msg::NotLoaded);
   Expect(!Initialized, Msg::AlreadyInit);
 
-  GetAsioDrivers().removeCurrentDriver();
+  Driver.reset();
   Loaded = false;
 }
 
 auto AsioContext::GetDeviceInfo() const -> DeviceInformation {
+  std::lock_guard lock{ControlMutex};
+
   Expect(Initialized, Msg::NotInit);
 
   return DeviceInfo;
 }
 
 ASIODriverInfo AsioContext::GetAsioInfo() const {
+  std::lock_guard lock{ControlMutex};
+
   Expect(Initialized, Msg::NotInit);
 
   return AsioInfo;
 }
 
 auto AsioContext::GetBuffersInfo() const -> BuffersInformation {
+  std::lock_guard lock{ControlMutex};
+
   Expect(BuffersCreated, Msg::BuffersAbsent);
 
   return ActiveBuffersInfo;
 }
 
+auto AsioContext::GetLatencyInfo() const -> LatencyInformation {
+  std::lock_guard lock{ControlMutex};
+
+  Expect(BuffersCreated, Msg::BuffersAbsent);
+
+  ASIOError status;
+  LatencyInformation info;
+
+  // Latencies may change while running, so they are not cached
+  long inputLatency = 0;
+  long outputLatency = 0;
+
+  if ((status = Driver->GetLatencies(&inputLatency, &outputLatency)) != ASE_OK)
+    throw Exception("ASIOGetLatencies()", status);
+
+  if ((status = Driver->GetSampleRate(&info.SampleRate)) != ASE_OK)
+    throw Exception("ASIOGetSampleRate()", status);
+
+  assert(inputLatency >= 0);
+  assert(outputLatency >= 0);
+
+  info.InputLatency = inputLatency;
+  info.OutputLatency = outputLatency;
+  info.BufferSize = ActiveBuffersInfo.BufferSize;
+  info.ProcessorLatency = Processor->GetLatency();
+
+  return info;
+}
+
+auto AsioContext::GetXrunInfo() const -> Helpers::XrunMonitor::Snapshot {
+  return Monitor.TakeSnapshot();
+}
+
+auto AsioContext::GetRecoveryInfo() const -> RecoveryInformation {
+  std::lock_guard lock{ControlMutex};
+  return RecoveryInfo;
+}
+
+size_t AsioContext::LatencyInformation::GetRoundTrip() const {
+  return InputLatency + OutputLatency + ProcessorLatency;
+}
+
+double AsioContext::LatencyInformation::ToMicroseconds(size_t samples) const {
+  if (SampleRate <= 0) return 0;
+  return samples * 1e6 / SampleRate;
+}
+
 void AsioContext::Expect(bool var, const char* msg) {
   if (!var) throw std::runtime_error(msg);
 }
@@ -193,7 +346,7 @@ auto AsioContext::GetDeviceInfoInternal() const -> DeviceInformation {
   long prefSize = info.BufferInfo.PrefSize;
   long granularity = info.BufferInfo.Granularity;
 
-  if ((status = ASIOGetChannels(&numInputs, &numOutputs)) != ASE_OK)
+  if ((status = Driver->GetChannels(&numInputs, &numOutputs)) != ASE_OK)
     throw Exception("ASIOGetChannels", status);
 
   numInputs = numInputs;
@@ -204,7 +357,7 @@ auto AsioContext::GetDeviceInfoInternal() const -> DeviceInformation {
     chinfo.isInput = i < numInputs;
     chinfo.channel = chinfo.isInput ? i : i - numInputs;
 
-    if ((status = ASIOGetChannelInfo(&chinfo)) != ASE_OK)
+    if ((status = Driver->GetChannelInfo(&chinfo)) != ASE_OK)
       throw Exception("ASIOGetChannelInfo()", status);
 
     if (chinfo.isInput) {
@@ -214,11 +367,11 @@ auto AsioContext::GetDeviceInfoInternal() const -> DeviceInformation {
     }
   }
 
-  if ((status = ASIOGetBufferSize(&minSize, &maxSize, &prefSize,
-                                  &granularity)) != ASE_OK)
+  if ((status = Driver->GetBufferSize(&minSize, &maxSize, &prefSize,
+                                      &granularity)) != ASE_OK)
     throw Exception("AsioGetBufferSize()", status);
 
-  if ((status = ASIOGetSampleRate(&info.SampleRate)) != ASE_OK)
+  if ((status = Driver->GetSampleRate(&info.SampleRate)) != ASE_OK)
     throw Exception("ASIOGetSampleRate()", status);
 
   // Idk why ASIO SDK uses a signed type for channel ID's
@@ -244,69 +397,310 @@ auto AsioContext::GetDeviceInfoInternal() const -> DeviceInformation {
   return info;
 }
 
-void AsioContext::CheckBufferSize(long bufSize) const {
-  assert(Initialized);
-
-  bool cond1 = bufSize < DeviceInfo.BufferInfo.MinSize;
-  bool cond2 = bufSize > DeviceInfo.BufferInfo.MaxSize;
-  bool cond3 = !!(bufSize % DeviceInfo.BufferInfo.Granularity);
+void AsioContext::CheckBufferSize(const DeviceInformation& info,
+                                  long bufSize) {
+  bool cond1 = bufSize < info.BufferInfo.MinSize;
+  bool cond2 = bufSize > info.BufferInfo.MaxSize;
+  bool cond3 = !!(bufSize % info.BufferInfo.Granularity);
 
   if (cond1 || cond2 || cond3)
     throw std::runtime_error("Incorrect buffer size");
 }
 
-void AsioContext::AsioBufferSwitchCallback(long index, ASIOBool processNow) {
-  // Yup it's the only way. We can't provide
-  // additional arguments to asio callbacks
-  const auto& asio = AsioContext::Get();
-  auto bufInfos = asio.GetBuffersInfo();
+void AsioContext::CheckBufferLayout(const DeviceInformation& info,
+                                    size_t bufferSize) const {
+  for (const auto& binfo : AsioBufferInfos)
+    Expect(binfo.channelNum < (binfo.isInput ? info.Inputs.size()
+                                             : info.Outputs.size()),
+           Msg::BadChannel);
+
+  CheckBufferSize(info, bufferSize);
+}
+
+void AsioContext::CheckChannels(const std::vector<ChannelId>& channels,
+                                size_t available) const {
+  for (auto channel : channels) Expect(channel < available, Msg::BadChannel);
+}
+
+void AsioContext::BuildBlocks(size_t bufferSize) {
+  size_t nInputs = ActiveBuffersInfo.NumInput;
+
+  for (long index = 0; index < 2; ++index) {
+    auto& channels = BlockChannels[index];
+    channels.clear();
+    channels.reserve(AsioBufferInfos.size());
+
+    for (const auto& binfo : AsioBufferInfos) {
+      // Device info lists every channel of the device in order,
+      // so it is indexed by the channel number, which was checked
+      // against its size before the buffers were created
+      long channel = binfo.channelNum;
+      const auto& channelInfo = binfo.isInput ? DeviceInfo.Inputs[channel]
+                                              : DeviceInfo.Outputs[channel];
+      assert(channelInfo.channel == channel);
+
+      auto converter = Helpers::GetSampleConverter(channelInfo.type);
+      channels.push_back(
+          {binfo.buffers[index], converter, channelInfo.type, channel});
+    }
+
+    auto all = std::span<const ChannelBuffer>{channels};
+
+    Blocks[index].Index = index;
+    Blocks[index].BufferSize = bufferSize;
+    Blocks[index].Inputs = all.first(nInputs);
+    Blocks[index].Outputs = all.subspan(nInputs);
+  }
+}
+
+uint32_t AsioContext::TakeRtErrors() {
+  return RtErrors.exchange(0, std::memory_order_acq_rel);
+}
+
+bool AsioContext::HasRtError(uint32_t errors, RtError error) {
+  return errors & static_cast<uint32_t>(error);
+}
+
+void AsioContext::RaiseRtError(RtError error) noexcept {
+  RtErrors.fetch_or(static_cast<uint32_t>(error), std::memory_order_release);
+}
+
+void AsioContext::NotifyHandler(DriverEvent event) noexcept {
+  const auto& handler = AsioContext::Get().Handler;
+
+  if (handler)
+    handler->HandleEvent(event);
+  else
+    RaiseRtError(RtError::NoHandler);
+}
+
+void AsioContext::SilenceOutputs(const Block& block) noexcept {
+  for (const auto& output : block.Outputs)
+    std::memset(output.Buffer, 0,
+                block.BufferSize * Helpers::GetSampleSize(output.Type));
+}
+
+auto AsioContext::MakeRequest(Request::Kind type) noexcept -> Request {
+  Request request{type};
+  request.RaisedAt = Helpers::TscClock::Now();
+  return request;
+}
+
+void AsioContext::PostRequest(const Request& request) noexcept {
+  auto& ctx = AsioContext::Get();
+
+  if (!ctx.Requests.Push(request)) return RaiseRtError(RtError::RequestDropped);
+
+  ctx.WakeSupervisor();
+}
+
+void AsioContext::WakeSupervisor() noexcept {
+  RequestSignal.fetch_add(1, std::memory_order_release);
+  RequestSignal.notify_one();
+}
+
+void AsioContext::SupervisorLoop() {
+  while (SupervisorRunning.load(std::memory_order_acquire)) {
+    // Anything posted after this load changes the signal,
+    // so the wait below can't miss it
+    uint32_t signal = RequestSignal.load(std::memory_order_acquire);
+
+    Request request;
+    while (Requests.Pop(request)) HandleRequest(request);
+
+    if (ReclaimPending.exchange(false, std::memory_order_acq_rel))
+      ReclaimRetired();
+
+    RequestSignal.wait(signal, std::memory_order_acquire);
+  }
+}
+
+void AsioContext::HandleRequest(const Request& request) {
+  std::lock_guard lock{ControlMutex};
+
+  if (request.Type == Request::Kind::SampleRateChange)
+    return HandleSampleRateChange(request);
 
-  for (int i = 0; i < bufInfos.NumInput + bufInfos.NumOutput; ++i) {
-    void* bufPtr = asio.AsioBufferInfos[i].buffers[index];
-    long channel = asio.AsioBufferInfos[i].channelNum;
-    bool isInput = asio.AsioBufferInfos[i].isInput;
+  if (!BuffersCreated) return;
 
-    const auto& channelInfo = isInput ? asio.DeviceInfo.Inputs[channel]
-                                      : asio.DeviceInfo.Outputs[channel];
+  try {
+    Recover(request);
+  } catch (const std::exception& e) {
+    // A rejected buffer size leaves the engine untouched, otherwise
+    // it is left in whatever state the failed step reached and the
+    // control thread may inspect it and start over
+    RecoveryInfo.Failures += 1;
+    std::cout << "Recovery failed: " << e.what() << std::endl;  // TODO LOGGER
+    return NotifyHandler(DriverEvent::ReconfigureFailed);
+  }
 
-    if (isInput)
-      asio.Processor->ProcessInput(channel, bufPtr, channelInfo.type);
-    else
-      asio.Processor->ProcessOutput(channel, bufPtr, channelInfo.type);
+  RecordRecovery(request.RaisedAt);
+
+  if (request.Type == Request::Kind::Reset)
+    NotifyHandler(DriverEvent::Reset);
+  else if (request.Type == Request::Kind::Resync)
+    NotifyHandler(DriverEvent::Resynced);
+  else
+    NotifyHandler(DriverEvent::BufferSizeChanged);
+}
+
+void AsioContext::Recover(const Request& request) {
+  size_t bufferSize = request.Type == Request::Kind::BufferSizeChange
+                          ? request.BufferSize
+                          : ActiveBuffersInfo.BufferSize;
+
+  // The driver stays open for a buffer size change, so the new size and
+  // the channel layout are checked against its current limits while
+  // still running. A rejected request leaves the engine as it was.
+  // The block tables need the new buffer pointers and the processor is
+  // the one in use, so both are rebuilt after the teardown; the tables
+  // keep their storage, the channel count does not change
+  if (request.Type == Request::Kind::BufferSizeChange) {
+    DeviceInformation info = GetDeviceInfoInternal();
+    CheckBufferLayout(info, bufferSize);
+    DeviceInfo = std::move(info);
   }
 
-  if (asio.PostOutput) ASIOOutputReady();
+  bool wasStarted = Started;
+  if (Started) Stop();
+
+  // Resync only restarts the engine, so the driver realigns its clock
+  if (request.Type != Request::Kind::Resync) {
+    DisposeBuffers();
+
+    // Reset closes and reopens the driver,
+    // channels and buffer limits may be different afterwards
+    if (request.Type == Request::Kind::Reset) {
+      DeInitDriver();
+      InitDriver();
+      CheckBufferLayout(DeviceInfo, bufferSize);
+    }
+
+    // Channel layout is kept from the previous CreateBuffers(),
+    // the processor is reconfigured but not recreated
+    SetupBuffers(bufferSize);
+  }
+
+  if (wasStarted) Start();
 }
 
-ASIOTime* AsioContext::AsioBufferSwitchTimeInfoCallback(ASIOTime* timeInfo,
-                                                        long index,
-                                                        ASIOBool processNow) {
-  AsioBufferSwitchCallback(index, processNow);
-  return nullptr;
+void AsioContext::ReclaimRetired() {
+  std::lock_guard lock{ControlMutex};
+
+  // Switches starting from now on see the new processor
+  WaitForSwitch();
+  Retired.clear();
 }
 
-void AsioContext::AsioSampleRateChangedCallback(ASIOSampleRate sRate) {
-  assert(0 && "Not yet implemented");
+void AsioContext::HandleSampleRateChange(const Request& request) {
+  if (!Initialized) return;
+
+  DeviceInfo.SampleRate = request.SampleRate;
+  if (!BuffersCreated) return NotifyHandler(DriverEvent::SampleRateChanged);
+
+  // The buffers stay the same, so the driver keeps running
+  // and only the processor is reconfigured
+  SuspendProcessing();
+
+  try {
+    PrepareProcessor(*Processor);
+  } catch (...) {
+    // Stays suspended: outputs are kept silent
+    return NotifyHandler(DriverEvent::ReconfigureFailed);
+  }
+
+  Monitor.Configure(ActiveBuffersInfo.BufferSize, request.SampleRate);
+
+  ResumeProcessing();
+  RecordRecovery(request.RaisedAt);
+
+  NotifyHandler(DriverEvent::SampleRateChanged);
+}
+
+void AsioContext::WaitForSwitch() {
+  while (InSwitch.load()) std::this_thread::yield();
+}
+
+void AsioContext::SuspendProcessing() {
+  Suspended.store(true);
+  WaitForSwitch();
+}
+
+void AsioContext::ResumeProcessing() {
+  Suspended.store(false, std::memory_order_release);
+}
+
+void AsioContext::RecordRecovery(uint64_t raisedAt) {
+  double ns = Helpers::TscClock::ToNs(Helpers::TscClock::Now() - raisedAt);
+
+  RecoveryInfo.Count += 1;
+  RecoveryInfo.LastNs = ns;
+  RecoveryInfo.MaxNs = std::max(RecoveryInfo.MaxNs, ns);
+}
+
+void AsioContext::StopSupervisor() {
+  if (!Supervisor.joinable()) return;
+
+  SupervisorRunning.store(false, std::memory_order_release);
+  WakeSupervisor();
+
+  Supervisor.join();
+}
+
+void AsioContext::AsioSampleRateChangedCallback(ASIOSampleRate sRate) noexcept {
+  Helpers::RtScope scope;
+
+  auto request = MakeRequest(Request::Kind::SampleRateChange);
+  request.SampleRate = sRate;
+
+  PostRequest(request);
 }
 
 long AsioContext::AsioMessageCallback(long selector, long value, void* message,
-                                      double* opt) {
+                                      double* opt) noexcept {
+  Helpers::RtScope scope;
+
   long ret = 0;
 
   switch (selector) {
     case kAsioSelectorSupported:
-      if (value == kAsioEngineVersion || kAsioResetRequest || kAsioOverload)
+      if (value == kAsioEngineVersion || value == kAsioResetRequest ||
+          value == kAsioOverload || value == kAsioSupportsTimeInfo ||
+          value == kAsioLatenciesChanged || value == kAsioResyncRequest ||
+          value == kAsioBufferSizeChange)
         ret = 1;
       break;
     case kAsioEngineVersion:
       ret = 2;
       break;
     case kAsioResetRequest:
+      PostRequest(MakeRequest(Request::Kind::Reset));
+      ret = 1;
+      break;
+    case kAsioResyncRequest:
+      PostRequest(MakeRequest(Request::Kind::Resync));
+      ret = 1;
+      break;
+    case kAsioBufferSizeChange: {
+      // Returning zero makes the driver fall back to a reset request
+      if (value <= 0) break;
+
+      auto request = MakeRequest(Request::Kind::BufferSizeChange);
+      request.BufferSize = value;
+      PostRequest(request);
+      ret = 1;
+    } break;
+    case kAsioSupportsTimeInfo:
+      // Switches go to BufferSwitchTimeInfo() with the driver's timing
       ret = 1;
       break;
     case kAsioOverload:
-      AsioContext::Get().Handler->HandleEvent(
-          AsioContext::DriverEvent::Overload);
+      AsioContext::Get().Monitor.RecordOverload();
+      NotifyHandler(DriverEvent::Overload);
+      break;
+    case kAsioLatenciesChanged:
+      NotifyHandler(DriverEvent::LatenciesChanged);
+      ret = 1;
       break;
   }
 
@@ -315,22 +709,24 @@ long AsioContext::AsioMessageCallback(long selector, long value, void* message,
 
 ASIOError AsioContext::DtorStopDriver() {
   if (!Started) return ASE_OK;
-  return ASIOStop();
+  return Driver->Stop();
 }
 
 ASIOError AsioContext::DtorDisposeBuffers() {
   if (!BuffersCreated) return ASE_OK;
-  return ASIODisposeBuffers();
+  return Driver->DisposeBuffers();
 }
 
 ASIOError AsioContext::DtorExitDriver() {
   if (!Initialized) return ASE_OK;
-  return ASIOExit();
+  return Driver->Exit();
 }
 
 AsioContext::~AsioContext() {
   ASIOError status = ASE_OK;
 
+  StopSupervisor();
+
   if ((status = DtorStopDriver()) != ASE_OK)
     std::cout << "ASIOStop: " << Helpers::ASIOErrorToStr(status)
               << std::endl;  // TODO LOGGER
@@ -343,28 +739,19 @@ AsioContext::~AsioContext() {
     std::cout << "ASIOExit: " << Helpers::ASIOErrorToStr(status)
               << std::endl;  // TODO LOGGER
 
-  GetAsioDrivers().removeCurrentDriver();
+  Driver.reset();
 }
 
 std::vector<std::string> AsioContext::GetDriverNames(size_t maxNames) {
   if (maxNames == 0) return {};
 
-  std::vector<char> buffer(ASIO_DRIVER_NAME_LEN * maxNames, 0);
-  std::vector<char*> pointers(maxNames, 0);
-
-  for (int i = 0; i < maxNames; ++i) {
-    pointers[i] = buffer.data() + i * ASIO_DRIVER_NAME_LEN;
-  }
-
-  auto drvAvailable =
-      GetAsioDrivers().getDriverNames(pointers.data(), pointers.size());
-
-  if (drvAvailable == 0) return {};
-
   std::vector<std::string> result;
 
-  for (int i = 0; i < drvAvailable; ++i) result.emplace_back(pointers[i]);
+#ifdef _WIN32
+  result = SdkAsioDriver::GetDriverNames(maxNames - 1);
+#endif
 
+  result.emplace_back(SimAsioDriver::Name);
   return result;
 }
 
@@ -374,6 +761,35 @@ void Helpers::DumpAsioInfo(std::ostream& out, const ASIODriverInfo& info) {
   out << TAB "Error message: " << info.errorMessage << std::endl;
 }
 
+void Helpers::DumpLatencyInfo(std::ostream& out,
+                              const AsioContext::LatencyInformation& info) {
+  auto line = [&](const char* name, size_t samples) {
+    out << TAB << name << samples << " samples ("
+        << info.ToMicroseconds(samples) << " us)" << std::endl;
+  };
+
+  out << "Latency info:" << std::endl;
+  line("Input:     ", info.InputLatency);
+  line("Output:    ", info.OutputLatency);
+  line("Buffer:    ", info.BufferSize);
+  line("Processor: ", info.ProcessorLatency);
+  line("RoundTrip: ", info.GetRoundTrip());
+}
+
+void Helpers::DumpXrunInfo(std::ostream& out,
+                           const Helpers::XrunMonitor::Snapshot& info) {
+  out << "Buffer switch load (fraction of " << info.PeriodNs / 1e3
+      << " us period):" << std::endl;
+  out << TAB "Switches:  " << info.Switches << std::endl;
+  out << TAB "Misses:    " << info.Misses << std::endl;
+  out << TAB "Overloads: " << info.Overloads << std::endl;
+  out << TAB "Mean:      " << info.GetMeanLoad() << std::endl;
+  out << TAB "P50:       " << info.GetLoadAtPercentile(50) << std::endl;
+  out << TAB "P99:       " << info.GetLoadAtPercentile(99) << std::endl;
+  out << TAB "P99.9:     " << info.GetLoadAtPercentile(99.9) << std::endl;
+  out << TAB "Max:       " << info.GetMaxLoad() << std::endl;
+}
+
 void Helpers::DumpDeviceInfo(std::ostream& out,
                              const AsioContext::DeviceInformation& info) {
   out << "Channels:" << std::endl;
@@ -479,12 +895,12 @@ Helpers::AsioProcessorMock::AsioProcessorMock(decltype(ProcessInputFunc) pi,
       ConfigureFunc{cf} {}
 
 void Helpers::AsioProcessorMock::ProcessInput(long channel, void* buf,
-                                              ASIOSampleType type) {
+                                              ASIOSampleType type) noexcept {
   ProcessInputFunc(channel, buf, type);
 }
 
 void Helpers::AsioProcessorMock::ProcessOutput(long channel, void* buf,
-                                               ASIOSampleType type) {
+                                               ASIOSampleType type) noexcept {
   ProcessOutputFunc(channel, buf, type);
 }
 
@@ -499,10 +915,62 @@ AsioContext::ProcessorT Helpers::AsioProcessorMock::Create(
   return std::make_unique<AsioProcessorMock>(pi, po, cf);
 };
 
+Helpers::AsioChannelAdapter::AsioChannelAdapter(
+    AsioContext::ProcessorT&& processor)
+    : AsioContext::IBlockProcessor{}, Processor{std::move(processor)} {}
+
+void Helpers::AsioChannelAdapter::ProcessBlock(
+    const AsioContext::Block& block) noexcept {
+  for (long i = 0; i < block.Inputs.size(); ++i)
+    Processor->ProcessInput(i, block.Inputs[i].Buffer, block.Inputs[i].Type);
+
+  for (long i = 0; i < block.Outputs.size(); ++i)
+    Processor->ProcessOutput(i, block.Outputs[i].Buffer,
+                             block.Outputs[i].Type);
+}
+
+void Helpers::AsioChannelAdapter::Configure(size_t bufSize, size_t nInputs,
+                                            size_t nOutputs) {
+  Processor->Configure(bufSize, nInputs, nOutputs);
+}
+
+size_t Helpers::AsioChannelAdapter::GetLatency() const {
+  return Processor->GetLatency();
+}
+
+void Helpers::AsioChannelAdapter::SetSampleRate(ASIOSampleRate sampleRate) {
+  Processor->SetSampleRate(sampleRate);
+}
+
+AsioContext::BlockProcessorT Helpers::AsioChannelAdapter::Create(
+    AsioContext::ProcessorT&& processor) {
+  return std::make_unique<AsioChannelAdapter>(std::move(processor));
+}
+
+Helpers::AsioBlockProcessorMock::AsioBlockProcessorMock(
+    decltype(ProcessBlockFunc) pb, decltype(ConfigureFunc) cf)
+    : AsioContext::IBlockProcessor{}, ProcessBlockFunc{pb}, ConfigureFunc{cf} {}
+
+void Helpers::AsioBlockProcessorMock::ProcessBlock(
+    const AsioContext::Block& block) noexcept {
+  ProcessBlockFunc(block);
+}
+
+void Helpers::AsioBlockProcessorMock::Configure(size_t bufSize, size_t nInputs,
+                                                size_t nOutputs) {
+  ConfigureFunc(bufSize, nInputs, nOutputs);
+}
+
+AsioContext::BlockProcessorT Helpers::AsioBlockProcessorMock::Create(
+    decltype(ProcessBlockFunc) pb, decltype(ConfigureFunc) cf) {
+  return std::make_unique<AsioBlockProcessorMock>(pb, cf);
+}
+
 Helpers::AsioHandlerMock::AsioHandlerMock(decltype(HandleFunc) handler)
     : AsioContext::IHandler{}, HandleFunc{handler} {}
 
-void Helpers::AsioHandlerMock::HandleEvent(AsioContext::DriverEvent event) {
+void Helpers::AsioHandlerMock::HandleEvent(
+    AsioContext::DriverEvent event) noexcept {
   HandleFunc(event);
 }
 
@@ -4,79 +4,49 @@
 #include <windows.h>
 // clang-format on
 
+#include <algorithm>
+#include <span>
+#include <string>
+#include <vector>
+
 #include "AsioContext.hpp"
-#include "PortableEndian.h"
 #include "Vst2Effect.hpp"
 
-#undef max  // I hate windows
-
-#include <limits>
-
 namespace GigOn {
 
 namespace Helpers {
 
-size_t AsioSample2VstFloat(const void* src, float* dst, ASIOSampleType type) {
-  assert(src);
-  assert(dst);
-
-#define CASEGEN(asioType, width, endianness)                  \
-  case asioType: {                                            \
-    using hostType = int##width##_t;                          \
-    hostType val = *reinterpret_cast<const hostType*>(src);   \
-    val = endianness##e##width##toh(val);                     \
-    *dst = float(val) / std::numeric_limits<hostType>::max(); \
-    return sizeof(hostType);                                  \
-  }
-
-  switch (type) {
-    CASEGEN(ASIOSTInt16LSB, 16, l);
-    CASEGEN(ASIOSTInt16MSB, 16, b);
-    CASEGEN(ASIOSTInt32LSB, 32, l);
-    CASEGEN(ASIOSTInt32MSB, 32, b);
+const SampleConverter& ExpectConverter(ASIOSampleType type, const char* label) {
+  auto converter = GetSampleConverter(type);
+  if (converter) return *converter;
 
-    default:
-      throw Helpers::LabelException(
-          "Asio2Vst conversion",
-          ASIOSampleTypeToStr(type) + std::string{"is not supported yet"});
-  }
-
-#undef CASEGEN
+  throw Helpers::LabelException(
+      label, ASIOSampleTypeToStr(type) + std::string{" is not supported yet"});
 }
 
-size_t VstFloat2AsioSample(const float* src, void* dst, ASIOSampleType type) {
-  assert(src);
-  assert(dst);
-
-#define CASEGEN(asioType, width, endianness)                       \
-  case asioType: {                                                 \
-    using hostType = int##width##_t;                               \
-    hostType* dst = reinterpret_cast<hostType*>(dst);              \
-    hostType sample = *src * std::numeric_limits<hostType>::max(); \
-    *dst = hto##endianness##e##width(sample);                      \
-    return sizeof(hostType);                                       \
-  }
-
-  switch (type) {
-    CASEGEN(ASIOSTInt16LSB, 16, l);
-    CASEGEN(ASIOSTInt16MSB, 16, b);
-    CASEGEN(ASIOSTInt32LSB, 32, l);
-    CASEGEN(ASIOSTInt32MSB, 32, b);
-
-    default:
-      throw Helpers::LabelException(
-          "Vst2Asio conversion",
-          ASIOSampleTypeToStr(type) + std::string{"is not supported yet"});
-  }
-}
-
-#undef CASEGEN
 }  // namespace Helpers
 
 struct AsioVstPlug final {
  private:
+  using Precision = Vst2Effect::Precision;
+
+  // Only the pair matching the effect's precision is allocated
   VstProcessBuffer Inputs{0, 0};
   VstProcessBuffer Outputs{0, 0};
+  VstProcessDoubleBuffer DoubleInputs{0, 0};
+  VstProcessDoubleBuffer DoubleOutputs{0, 0};
+
+  // Per channel, nullptr for channels passed to the plugin in place
+  std::vector<const Helpers::SampleConverter*> InputConverters;
+  std::vector<const Helpers::SampleConverter*> OutputConverters;
+
+  // Shifted channel pointers of the sub-block being processed
+  std::vector<float*> InputSlice, OutputSlice;
+  std::vector<double*> DoubleInputSlice, DoubleOutputSlice;
+
+  // Integer outputs are dithered, one generator per channel
+  Helpers::DitherMode Dither = Helpers::DitherMode::Tpdf;
+  std::vector<Helpers::DitherState> Dithers;
 
  public:
   AsioVstPlug() = default;
@@ -89,33 +59,246 @@ struct AsioVstPlug final {
   ~AsioVstPlug() = default;
 
  public:
-  void Configure(size_t blockSize, size_t nInputs, size_t nOutputs) {
-    Inputs = VstProcessBuffer(blockSize, nInputs);
-    Outputs = VstProcessBuffer(blockSize, nOutputs);
+  // blockSize is the driver's buffer size, the effect may be configured
+  // with a smaller one. The types are the sample types of the block's
+  // channels, see AsioContext::GetDeviceInfo(). The effect has to be
+  // configured already, its precision is used. Throws if the channel
+  // counts differ from the effect's or a channel's type can't be
+  // converted, the process calls check nothing of that
+  void Configure(const Vst2Effect& effect, size_t blockSize,
+                 std::span<const ASIOSampleType> inputTypes,
+                 std::span<const ASIOSampleType> outputTypes) {
+    bool single = effect.GetPrecision() == Precision::Single;
+    size_t nInputs = inputTypes.size();
+    size_t nOutputs = outputTypes.size();
+
+    CheckChannels(effect, nInputs, nOutputs);
+    ConfigureConverters(inputTypes, outputTypes, single);
+
+    Inputs = VstProcessBuffer(single ? blockSize : 0, single ? nInputs : 0);
+    Outputs = VstProcessBuffer(single ? blockSize : 0, single ? nOutputs : 0);
+    DoubleInputs =
+        VstProcessDoubleBuffer(single ? 0 : blockSize, single ? 0 : nInputs);
+    DoubleOutputs =
+        VstProcessDoubleBuffer(single ? 0 : blockSize, single ? 0 : nOutputs);
+
+    ConfigureState(nInputs, nOutputs, single);
+  }
+
+  // Same with the buffers placed in arena, which is shared by the whole
+  // chain. Reset it once before reconfiguring the chain: until this plug
+  // is configured again its buffers point into recycled memory
+  void Configure(BufferArena& arena, const Vst2Effect& effect,
+                 size_t blockSize, std::span<const ASIOSampleType> inputTypes,
+                 std::span<const ASIOSampleType> outputTypes) {
+    bool single = effect.GetPrecision() == Precision::Single;
+    size_t nInputs = inputTypes.size();
+    size_t nOutputs = outputTypes.size();
+
+    CheckChannels(effect, nInputs, nOutputs);
+    ConfigureConverters(inputTypes, outputTypes, single);
+
+    Inputs = VstProcessBuffer{arena, blockSize, single ? nInputs : 0};
+    Outputs = VstProcessBuffer{arena, blockSize, single ? nOutputs : 0};
+    DoubleInputs =
+        VstProcessDoubleBuffer{arena, blockSize, single ? 0 : nInputs};
+    DoubleOutputs =
+        VstProcessDoubleBuffer{arena, blockSize, single ? 0 : nOutputs};
+
+    ConfigureState(nInputs, nOutputs, single);
+  }
+
+  // Takes effect on the next Configure()
+  void SetDitherMode(Helpers::DitherMode mode) { Dither = mode; }
+
+ private:
+  static void CheckChannels(const Vst2Effect& effect, size_t nInputs,
+                            size_t nOutputs) {
+    auto info = effect.GetInfo();
+
+    if (info.NumInputs != nInputs || info.NumOutputs != nOutputs)
+      throw Helpers::LabelException(
+          "AsioVstPlug", "Channel count differs from the effect's: " +
+                             std::to_string(info.NumInputs) + " in, " +
+                             std::to_string(info.NumOutputs) + " out");
+  }
+
+  // Channels in the plugin's own sample format get no converter,
+  // the plugin works on the driver buffer in place
+  static std::vector<const Helpers::SampleConverter*> ResolveConverters(
+      std::span<const ASIOSampleType> types, bool single, const char* label) {
+    std::vector<const Helpers::SampleConverter*> converters;
+
+    for (ASIOSampleType type : types) {
+      bool native = single ? Helpers::IsNativeFloat(type)
+                           : Helpers::IsNativeDouble(type);
+      converters.push_back(native ? nullptr
+                                  : &Helpers::ExpectConverter(type, label));
+    }
+
+    return converters;
+  }
+
+  void ConfigureConverters(std::span<const ASIOSampleType> inputTypes,
+                           std::span<const ASIOSampleType> outputTypes,
+                           bool single) {
+    InputConverters =
+        ResolveConverters(inputTypes, single, "Asio2Vst conversion");
+    OutputConverters =
+        ResolveConverters(outputTypes, single, "Vst2Asio conversion");
   }
 
-  void Asio2VstInput(long channel, void* buffer, ASIOSampleType type) {
+  void ConfigureState(size_t nInputs, size_t nOutputs, bool single) {
+    InputSlice.assign(single ? nInputs : 0, nullptr);
+    OutputSlice.assign(single ? nOutputs : 0, nullptr);
+    DoubleInputSlice.assign(single ? 0 : nInputs, nullptr);
+    DoubleOutputSlice.assign(single ? 0 : nOutputs, nullptr);
+
+    Dithers.clear();
+    for (size_t i = 0; i < nOutputs; ++i)
+      Dithers.emplace_back(Dither, uint32_t(i + 1));
+  }
+
+ public:
+  // The converters were chosen by Configure(), nothing here looks
+  // them up or throws
+  void Asio2VstInput(size_t channel, void* buffer) noexcept {
     assert(buffer);
-    assert(channel >= 0);
+    assert(channel < InputConverters.size());
 
-    float* dst = Inputs.GetBufferByChannel(channel);
-    const uint8_t* src = reinterpret_cast<uint8_t*>(buffer);
+    // The plugin reads the driver buffer in place
+    const auto* converter = InputConverters[channel];
+    if (!converter) {
+      Inputs.SetBufferByChannel(channel, static_cast<float*>(buffer));
+      return;
+    }
 
-    size_t sz = Inputs.GetBlockSize();
-    for (size_t i = 0; i < sz; ++i)
-      src += Helpers::AsioSample2VstFloat(src, dst + i, type);
+    Inputs.ResetBufferByChannel(channel);
+    float* dst = Inputs.GetBufferByChannel(channel);
+    converter->ToFloat(buffer, dst, Inputs.GetBlockSize());
   }
 
-  void Vst2AsioOutput(long channel, void* buffer, ASIOSampleType type) const {
+  void Vst2AsioOutput(size_t channel, void* buffer) noexcept {
     assert(buffer);
-    assert(channel >= 0);
+    assert(channel < OutputConverters.size());
 
     const float* src = Outputs.GetBufferByChannel(channel);
-    uint8_t* dst = reinterpret_cast<uint8_t*>(buffer);
+    if (src == buffer) return;  // Written in place by the plugin
+
+    OutputConverters[channel]->FromFloatDither(
+        src, buffer, Outputs.GetBlockSize(), Dithers[channel]);
+  }
+
+  // Double-precision counterparts of the above. 64-bit formats go to
+  // the plugin as they are, the others are converted straight to double
+  void Asio2VstDoubleInput(size_t channel, void* buffer) noexcept {
+    assert(buffer);
+    assert(channel < InputConverters.size());
+
+    const auto* converter = InputConverters[channel];
+    if (!converter) {
+      DoubleInputs.SetBufferByChannel(channel, static_cast<double*>(buffer));
+      return;
+    }
+
+    DoubleInputs.ResetBufferByChannel(channel);
+    double* dst = DoubleInputs.GetBufferByChannel(channel);
+    converter->ToDouble(buffer, dst, DoubleInputs.GetBlockSize());
+  }
+
+  void Vst2AsioDoubleOutput(size_t channel, void* buffer) noexcept {
+    assert(buffer);
+    assert(channel < OutputConverters.size());
+
+    const double* src = DoubleOutputs.GetBufferByChannel(channel);
+    if (src == buffer) return;  // Written in place by the plugin
+
+    OutputConverters[channel]->FromDoubleDither(
+        src, buffer, DoubleOutputs.GetBlockSize(), Dithers[channel]);
+  }
+
+  // Runs the effect on a whole block. Channels in the native float format
+  // are not copied: the plugin works on the driver's buffers of the
+  // current half directly, the others are converted around the call.
+  // Blocks larger than the effect's block size are processed in
+  // sub-blocks of it, conversion still runs on the whole block.
+  // Effects set to double precision go through ProcessDoubleBlock().
+  // Nothing here throws, errors of the effect's process calls are
+  // collected by Vst2Effect::TakeProcessErrors()
+  void ProcessBlock(const AsioContext::Block& block,
+                    Vst2Effect& effect) noexcept {
+    if (effect.GetPrecision() == Precision::Double)
+      return ProcessDoubleBlock(block, effect);
+
+    assert(block.BufferSize == Inputs.GetBlockSize());
+    assert(block.Inputs.size() == InputConverters.size());
+    assert(block.Outputs.size() == OutputConverters.size());
+
+    for (size_t i = 0; i < block.Inputs.size(); ++i)
+      Asio2VstInput(i, block.Inputs[i].Buffer);
+
+    for (size_t i = 0; i < block.Outputs.size(); ++i) {
+      auto buffer = static_cast<float*>(block.Outputs[i].Buffer);
+
+      if (!OutputConverters[i])
+        Outputs.SetBufferByChannel(i, buffer);
+      else
+        Outputs.ResetBufferByChannel(i);
+    }
+
+    ProcessSplit(effect, Inputs, Outputs, InputSlice, OutputSlice);
+
+    for (size_t i = 0; i < block.Outputs.size(); ++i)
+      Vst2AsioOutput(i, block.Outputs[i].Buffer);
+  }
+
+  // Same with processDoubleReplacing(), native double channels
+  // are the ones passed in place
+  void ProcessDoubleBlock(const AsioContext::Block& block,
+                          Vst2Effect& effect) noexcept {
+    assert(block.BufferSize == DoubleInputs.GetBlockSize());
+    assert(block.Inputs.size() == InputConverters.size());
+    assert(block.Outputs.size() == OutputConverters.size());
+
+    for (size_t i = 0; i < block.Inputs.size(); ++i)
+      Asio2VstDoubleInput(i, block.Inputs[i].Buffer);
+
+    for (size_t i = 0; i < block.Outputs.size(); ++i) {
+      auto buffer = static_cast<double*>(block.Outputs[i].Buffer);
+
+      if (!OutputConverters[i])
+        DoubleOutputs.SetBufferByChannel(i, buffer);
+      else
+        DoubleOutputs.ResetBufferByChannel(i);
+    }
+
+    ProcessSplit(effect, DoubleInputs, DoubleOutputs, DoubleInputSlice,
+                 DoubleOutputSlice);
+
+    for (size_t i = 0; i < block.Outputs.size(); ++i)
+      Vst2AsioDoubleOutput(i, block.Outputs[i].Buffer);
+  }
+
+  // One call when the block fits the effect, otherwise
+  // effect-sized slices and a shorter last one
+  template <typename T>
+  void ProcessSplit(Vst2Effect& effect, BasicVstProcessBuffer<T>& inputs,
+                    BasicVstProcessBuffer<T>& outputs,
+                    std::vector<T*>& inputSlice,
+                    std::vector<T*>& outputSlice) noexcept {
+    size_t frames = inputs.GetBlockSize();
+    size_t step = effect.GetBlockSize();
+
+    if (step == 0 || frames <= step) return effect.Process(inputs, outputs);
+
+    BasicVstProcessView<T> in{inputs}, out{outputs};
+
+    for (size_t offset = 0; offset < frames; offset += step) {
+      size_t size = std::min(step, frames - offset);
 
-    size_t sz = Outputs.GetBlockSize();
-    for (size_t i = 0; i < sz; ++i)
-      dst += Helpers::VstFloat2AsioSample(src + i, dst, type);
+      effect.Process(in.Slice(offset, size, inputSlice.data()),
+                     out.Slice(offset, size, outputSlice.data()));
+    }
   }
 
   const VstProcessBuffer& GetVstInputs() { return Inputs; }
@@ -0,0 +1,214 @@
+#ifdef _WIN32
+// clang-format off
+#include <winsock2.h>
+#include <windows.h>
+// clang-format on
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "BufferArena.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#include "Aligned.hpp"
+
+namespace GigOn {
+
+namespace {
+
+#ifndef _WIN32
+// MAP_HUGETLB takes the default huge page size, 2M on x86-64 and
+// most arm64 kernels
+const size_t HugePageSize = 2 << 20;
+#endif
+
+size_t RoundUp(size_t value, size_t step) {
+  return (value + step - 1) / step * step;
+}
+
+size_t GetPageSize() {
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwPageSize;
+#else
+  return size_t(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+// Touches every page so that the first buffer switch after
+// reconfiguration doesn't take the page faults
+void FaultIn(uint8_t* base, size_t size) {
+  static const size_t pageSize = GetPageSize();
+
+  for (size_t offset = 0; offset < size; offset += pageSize)
+    reinterpret_cast<volatile uint8_t*>(base)[offset] = 0;
+}
+
+}  // namespace
+
+BufferArena::BufferArena() : BufferArena{Config{}} {}
+
+BufferArena::BufferArena(const Config& config) : Conf{config} {}
+
+BufferArena::BufferArena(BufferArena&& other) noexcept
+    : Conf{other.Conf},
+      Regions{std::move(other.Regions)},
+      Current{std::exchange(other.Current, 0)} {
+  other.Regions.clear();
+}
+
+BufferArena& BufferArena::operator=(BufferArena&& other) noexcept {
+  if (this == &other) return *this;
+
+  Release();
+  Conf = other.Conf;
+  Regions = std::move(other.Regions);
+  Current = std::exchange(other.Current, 0);
+  other.Regions.clear();
+  return *this;
+}
+
+BufferArena::~BufferArena() { Release(); }
+
+void* BufferArena::Allocate(size_t bytes) {
+  bytes = RoundUp(bytes ? bytes : 1, Helpers::CacheLineSize);
+
+  // Full regions are skipped for good until Reset(), the tail
+  // of one rarely fits the next channel block anyway
+  while (Current < Regions.size() &&
+         Regions[Current].Size - Regions[Current].Used < bytes)
+    ++Current;
+
+  if (Current == Regions.size()) Regions.push_back(MapRegion(bytes));
+
+  Region& region = Regions[Current];
+  uint8_t* block = region.Base + region.Used;
+  region.Used += bytes;
+
+  std::memset(block, 0, bytes);
+  return block;
+}
+
+void BufferArena::Reset() {
+  for (auto& region : Regions) region.Used = 0;
+  Current = 0;
+}
+
+void BufferArena::Release() {
+  for (const auto& region : Regions) UnmapRegion(region);
+
+  Regions.clear();
+  Current = 0;
+}
+
+auto BufferArena::GetStats() const -> Stats {
+  Stats stats;
+
+  for (const auto& region : Regions) {
+    ++stats.Regions;
+    stats.HugePageRegions += region.HugePages;
+    stats.LockedRegions += region.Locked;
+    stats.ReservedBytes += region.Size;
+    stats.UsedBytes += region.Used;
+  }
+
+  return stats;
+}
+
+auto BufferArena::GetConfig() const -> const Config& { return Conf; }
+
+#ifdef _WIN32
+
+// Large pages need SeLockMemoryPrivilege, locking needs a working set
+// big enough to hold the region. Either one may be refused
+auto BufferArena::MapRegion(size_t bytes) const -> Region {
+  Region region;
+  size_t size = RoundUp(std::max(bytes, Conf.RegionSize), GetPageSize());
+
+  if (size_t largePage = GetLargePageMinimum();
+      Conf.HugePages && largePage > 0) {
+    size_t largeSize = RoundUp(size, largePage);
+    void* base = VirtualAlloc(nullptr, largeSize,
+                              MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                              PAGE_READWRITE);
+    if (base) region = {static_cast<uint8_t*>(base), largeSize, 0, true};
+  }
+
+  if (!region.Base) {
+    void* base = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT,
+                              PAGE_READWRITE);
+    if (!base) throw std::bad_alloc{};
+    region = {static_cast<uint8_t*>(base), size};
+  }
+
+  // Large pages are never paged out
+  if (Conf.Lock && !region.HugePages) {
+    HANDLE process = GetCurrentProcess();
+    SIZE_T minSize, maxSize;
+
+    if (GetProcessWorkingSetSize(process, &minSize, &maxSize))
+      SetProcessWorkingSetSize(process, minSize + region.Size,
+                               maxSize + region.Size);
+
+    region.Locked = VirtualLock(region.Base, region.Size);
+  } else {
+    region.Locked = region.HugePages;
+  }
+
+  FaultIn(region.Base, region.Size);
+  return region;
+}
+
+void BufferArena::UnmapRegion(const Region& region) {
+  VirtualFree(region.Base, 0, MEM_RELEASE);
+}
+
+#else
+
+// Explicit huge pages come from the hugetlbfs pool, which is empty
+// unless vm.nr_hugepages is set. Transparent ones are asked for then
+auto BufferArena::MapRegion(size_t bytes) const -> Region {
+  Region region;
+  size_t size = RoundUp(std::max(bytes, Conf.RegionSize), GetPageSize());
+
+#ifdef MAP_HUGETLB
+  if (Conf.HugePages) {
+    size_t hugeSize = RoundUp(size, HugePageSize);
+    void* base = mmap(nullptr, hugeSize, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (base != MAP_FAILED)
+      region = {static_cast<uint8_t*>(base), hugeSize, 0, true};
+  }
+#endif
+
+  if (!region.Base) {
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) throw std::bad_alloc{};
+    region = {static_cast<uint8_t*>(base), size};
+
+#ifdef MADV_HUGEPAGE
+    if (Conf.HugePages) madvise(base, size, MADV_HUGEPAGE);
+#endif
+  }
+
+  // Fails past RLIMIT_MEMLOCK without CAP_IPC_LOCK
+  if (Conf.Lock) region.Locked = mlock(region.Base, region.Size) == 0;
+
+  FaultIn(region.Base, region.Size);
+  return region;
+}
+
+void BufferArena::UnmapRegion(const Region& region) {
+  munmap(region.Base, region.Size);
+}
+
+#endif
+
+}  // namespace GigOn
@@ -0,0 +1,95 @@
+#include "HdrHistogram.hpp"
+
+#include <cmath>
+
+namespace GigOn {
+namespace Helpers {
+
+/*** HdrHistogram ***/
+
+HdrHistogram::HdrHistogram(uint64_t maxValue)
+    : MaxValue{maxValue},
+      NumBuckets{GetBucket(maxValue) + 1},
+      Counts{std::make_unique<std::atomic<uint64_t>[]>(NumBuckets)} {}
+
+auto HdrHistogram::TakeSnapshot() const -> Snapshot {
+  Snapshot snapshot;
+  snapshot.Counts.resize(NumBuckets);
+
+  // Total is read first, so it never exceeds the sum of the counts
+  uint64_t total = TotalCount.load(std::memory_order_acquire);
+  uint64_t sum = 0;
+
+  for (size_t i = 0; i < NumBuckets; ++i) {
+    snapshot.Counts[i] = Counts[i].load(std::memory_order_relaxed);
+    sum += snapshot.Counts[i];
+  }
+
+  snapshot.TotalCount = sum < total ? sum : total;
+  return snapshot;
+}
+
+uint64_t HdrHistogram::GetMaxValue() const { return MaxValue; }
+
+uint64_t HdrHistogram::GetBucketLow(size_t bucket) {
+  size_t shift = bucket < 2 * SubBucketCount ? 0 : (bucket >> SubBucketBits) - 1;
+  return (bucket - (shift << SubBucketBits)) << shift;
+}
+
+uint64_t HdrHistogram::GetBucketHigh(size_t bucket) {
+  size_t shift = bucket < 2 * SubBucketCount ? 0 : (bucket >> SubBucketBits) - 1;
+  return GetBucketLow(bucket) + (uint64_t(1) << shift) - 1;
+}
+
+/*** HdrHistogram::Snapshot ***/
+
+uint64_t HdrHistogram::Snapshot::GetValueAtPercentile(double percentile) const {
+  if (TotalCount == 0) return 0;
+
+  auto target = uint64_t(std::ceil(percentile / 100 * TotalCount));
+  if (target == 0) target = 1;
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < Counts.size(); ++i) {
+    seen += Counts[i];
+    if (seen >= target) return GetBucketHigh(i);
+  }
+
+  return GetMax();
+}
+
+uint64_t HdrHistogram::Snapshot::GetMax() const {
+  for (size_t i = Counts.size(); i > 0; --i)
+    if (Counts[i - 1]) return GetBucketHigh(i - 1);
+
+  return 0;
+}
+
+double HdrHistogram::Snapshot::GetMean() const {
+  if (TotalCount == 0) return 0;
+
+  double sum = 0;
+  uint64_t count = 0;
+
+  // Bucket midpoints
+  for (size_t i = 0; i < Counts.size(); ++i) {
+    sum += Counts[i] * (GetBucketLow(i) + GetBucketHigh(i)) / 2.;
+    count += Counts[i];
+  }
+
+  return sum / count;
+}
+
+auto HdrHistogram::Snapshot::Since(const Snapshot& earlier) const
+    -> Snapshot {
+  Snapshot delta = *this;
+
+  for (size_t i = 0; i < delta.Counts.size() && i < earlier.Counts.size(); ++i)
+    delta.Counts[i] -= earlier.Counts[i];
+
+  delta.TotalCount -= earlier.TotalCount;
+  return delta;
+}
+
+}  // namespace Helpers
+}  // namespace GigOn
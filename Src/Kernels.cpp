@@ -0,0 +1,173 @@
+#include "Kernels.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#if defined(GIGON_KERNELS_X86)
+#if defined(_MSC_VER) || (defined(_WIN32) && defined(__clang__))
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace GigOn {
+namespace Helpers {
+
+// Defined in Src/Kernels<Tier>.cpp. Only the ones
+// for the target architecture are part of the build
+extern const KernelTable ScalarKernels;
+#if defined(GIGON_KERNELS_X86)
+extern const KernelTable Sse2Kernels;
+extern const KernelTable Avx2Kernels;
+extern const KernelTable Avx512Kernels;
+#elif defined(GIGON_KERNELS_NEON)
+extern const KernelTable NeonKernels;
+#endif
+
+namespace {
+
+#if defined(GIGON_KERNELS_X86)
+
+struct CpuIdRegs {
+  uint32_t Eax = 0, Ebx = 0, Ecx = 0, Edx = 0;
+};
+
+CpuIdRegs CpuId(uint32_t leaf, uint32_t subleaf) {
+  CpuIdRegs regs;
+#if defined(_MSC_VER) || (defined(_WIN32) && defined(__clang__))
+  int out[4];
+  __cpuidex(out, leaf, subleaf);
+  regs = {uint32_t(out[0]), uint32_t(out[1]), uint32_t(out[2]),
+          uint32_t(out[3])};
+#else
+  __cpuid_count(leaf, subleaf, regs.Eax, regs.Ebx, regs.Ecx, regs.Edx);
+#endif
+  return regs;
+}
+
+// Register state the OS saves on context switches
+uint64_t GetXcr0() {
+#if defined(_MSC_VER) || (defined(_WIN32) && defined(__clang__))
+  return _xgetbv(0);
+#else
+  uint32_t eax, edx;
+  asm volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return uint64_t(edx) << 32 | eax;
+#endif
+}
+
+CpuTier ProbeTier() {
+  const uint32_t maxLeaf = CpuId(0, 0).Eax;
+  const CpuIdRegs leaf1 = CpuId(1, 0);
+
+  if (!(leaf1.Edx & (1u << 26))) return CpuTier::Scalar;
+
+  // AVX state has to be enabled by the OS, not just present
+  bool osxsave = leaf1.Ecx & (1u << 27);
+  if (!osxsave || maxLeaf < 7) return CpuTier::Sse2;
+
+  const uint64_t xcr0 = GetXcr0();
+  const CpuIdRegs leaf7 = CpuId(7, 0);
+
+  bool ymm = (xcr0 & 0x6) == 0x6;
+  bool avx2 = (leaf1.Ecx & (1u << 28)) && (leaf7.Ebx & (1u << 5));
+  if (!ymm || !avx2) return CpuTier::Sse2;
+
+  bool zmm = (xcr0 & 0xe6) == 0xe6;
+  bool avx512 = (leaf7.Ebx & (1u << 16)) && (leaf7.Ebx & (1u << 30));
+  if (!zmm || !avx512) return CpuTier::Avx2;
+
+  return CpuTier::Avx512;
+}
+
+#elif defined(GIGON_KERNELS_NEON)
+
+CpuTier ProbeTier() { return CpuTier::Neon; }
+
+#else
+
+CpuTier ProbeTier() { return CpuTier::Scalar; }
+
+#endif
+
+const KernelTable* FindTable(CpuTier tier) {
+  switch (tier) {
+    case CpuTier::Scalar:
+      return &ScalarKernels;
+#if defined(GIGON_KERNELS_X86)
+    case CpuTier::Sse2:
+      return &Sse2Kernels;
+    case CpuTier::Avx2:
+      return &Avx2Kernels;
+    case CpuTier::Avx512:
+      return &Avx512Kernels;
+#elif defined(GIGON_KERNELS_NEON)
+    case CpuTier::Neon:
+      return &NeonKernels;
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+const KernelTable& BindKernels() {
+  CpuTier tier = GetBestTier();
+
+  if (const char* name = std::getenv(CpuTierVariable)) {
+    for (CpuTier candidate : {CpuTier::Scalar, CpuTier::Sse2, CpuTier::Avx2,
+                              CpuTier::Avx512, CpuTier::Neon}) {
+      if (std::string{name} == CpuTierToStr(candidate) &&
+          IsSupported(candidate))
+        tier = candidate;
+    }
+  }
+
+  return *FindTable(tier);
+}
+
+}  // namespace
+
+const char* CpuTierToStr(CpuTier tier) {
+  switch (tier) {
+    case CpuTier::Scalar:
+      return "scalar";
+    case CpuTier::Sse2:
+      return "sse2";
+    case CpuTier::Avx2:
+      return "avx2";
+    case CpuTier::Avx512:
+      return "avx512";
+    case CpuTier::Neon:
+      return "neon";
+    default:
+      return "unknown";
+  }
+}
+
+CpuTier GetBestTier() {
+  static const CpuTier tier = ProbeTier();
+  return tier;
+}
+
+bool IsSupported(CpuTier tier) {
+  if (!FindTable(tier)) return false;
+
+  // x86 tiers are ordered, each one includes the ones below
+  CpuTier best = GetBestTier();
+  if (tier == CpuTier::Scalar || tier == best) return true;
+  return best != CpuTier::Neon && tier != CpuTier::Neon && tier < best;
+}
+
+const KernelTable& GetKernels() {
+  static const KernelTable& kernels = BindKernels();
+  return kernels;
+}
+
+const KernelTable* GetKernels(CpuTier tier) {
+  return IsSupported(tier) ? FindTable(tier) : nullptr;
+}
+
+}  // namespace Helpers
+}  // namespace GigOn
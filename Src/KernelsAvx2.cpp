@@ -0,0 +1,463 @@
+#include <immintrin.h>
+
+#include "KernelsImpl.hpp"
+
+// Compiled with -mavx2, only called when the CPU has it
+
+namespace GigOn {
+namespace Helpers {
+
+namespace {
+
+// Reverses the bytes of every Width-byte element
+template <int Width>
+__m256i Reverse(__m256i x) {
+  if constexpr (Width == 2)
+    return _mm256_or_si256(_mm256_slli_epi16(x, 8), _mm256_srli_epi16(x, 8));
+
+  const __m256i mask =
+      Width == 4
+          ? _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13,
+                             12, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14,
+                             13, 12)
+          : _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9,
+                             8, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10,
+                             9, 8);
+  return _mm256_shuffle_epi8(x, mask);
+}
+
+// 8 floats -> 8 x int32, see Quantize()
+inline __m256i Quantize(__m256 x, __m256d scale) {
+  x = _mm256_max_ps(x, _mm256_set1_ps(-1.f));
+  x = _mm256_min_ps(x, _mm256_set1_ps(1.f));
+
+  __m256d lo = _mm256_cvtps_pd(_mm256_castps256_ps128(x));
+  __m256d hi = _mm256_cvtps_pd(_mm256_extractf128_ps(x, 1));
+
+  return _mm256_set_m128i(_mm256_cvttpd_epi32(_mm256_mul_pd(hi, scale)),
+                          _mm256_cvttpd_epi32(_mm256_mul_pd(lo, scale)));
+}
+
+// 8 floats -> 8 x int32 with dither, see QuantizeDithered(). The 16
+// generator lanes of a DitherState live in 2 registers that swap after
+// each call, so sample i gets lane i % 16 as long as calls come in
+// sample order
+template <DitherMode Mode>
+struct Ditherer {
+  __m256i Random[2];
+  __m256 Last;
+  __m256 Max;
+  __m256 Min;
+  size_t Calls = 0;
+
+  Ditherer(const DitherState& state, float max)
+      : Last{_mm256_set1_ps(state.Last)},
+        Max{_mm256_set1_ps(max)},
+        Min{_mm256_set1_ps(-max - 1.f)} {
+    for (size_t i = 0; i < 2; ++i)
+      Random[i] = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i*>(state.Random + 8 * i));
+  }
+
+  __m256i operator()(__m256 x) {
+    __m256 dither = _mm256_setzero_ps();
+
+    if constexpr (Mode != DitherMode::None) {
+      __m256i r = Random[0];
+      r = _mm256_xor_si256(r, _mm256_slli_epi32(r, 13));
+      r = _mm256_xor_si256(r, _mm256_srli_epi32(r, 17));
+      r = _mm256_xor_si256(r, _mm256_slli_epi32(r, 5));
+
+      Random[0] = Random[1];
+      Random[1] = r;
+      ++Calls;
+
+      if constexpr (Mode == DitherMode::Tpdf) {
+        __m256i diff =
+            _mm256_sub_epi32(_mm256_and_si256(r, _mm256_set1_epi32(0xffff)),
+                             _mm256_srli_epi32(r, 16));
+        dither = _mm256_mul_ps(_mm256_cvtepi32_ps(diff),
+                               _mm256_set1_ps(1.f / 65536));
+      } else {
+        __m256 uniform =
+            _mm256_mul_ps(_mm256_cvtepi32_ps(r), _mm256_set1_ps(0x1p-32f));
+
+        // Previous draw of every lane: rotate up by one and
+        // take lane 0 from the last draw of the call before
+        const __m256i up = _mm256_setr_epi32(7, 0, 1, 2, 3, 4, 5, 6);
+        __m256 prev = _mm256_blend_ps(_mm256_permutevar8x32_ps(uniform, up),
+                                      _mm256_permutevar8x32_ps(Last, up), 1);
+        dither = _mm256_sub_ps(uniform, prev);
+        Last = uniform;
+      }
+    }
+
+    x = _mm256_add_ps(_mm256_mul_ps(x, Max), dither);
+    x = _mm256_min_ps(_mm256_max_ps(x, Min), Max);
+    return _mm256_cvtps_epi32(x);
+  }
+
+  void Save(DitherState& state) const {
+    for (size_t i = 0; i < 2; ++i)
+      _mm256_storeu_si256(
+          reinterpret_cast<__m256i*>(state.Random + 8 * ((Calls + i) % 2)),
+          Random[i]);
+    state.Last = _mm256_cvtss_f32(_mm256_permutevar8x32_ps(
+        Last, _mm256_set1_epi32(7)));
+  }
+};
+
+// Gain ramp and meter of the fused kernels for 8 samples at a time,
+// see Strip. The 16 partial sums swap like the lanes of Ditherer
+struct VectorStrip {
+  __m256 Gain;
+  __m256 Step;
+  __m256 Index;
+  __m256 Peak;
+  __m256 Squares[2];
+  size_t Calls = 0;
+
+  VectorStrip(float gain, float step, const MeterState& meter)
+      : Gain{_mm256_set1_ps(gain)},
+        Step{_mm256_set1_ps(step)},
+        Index{_mm256_setr_ps(1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f)},
+        Peak{_mm256_set1_ps(meter.Peak)} {
+    for (size_t i = 0; i < 2; ++i)
+      Squares[i] = _mm256_loadu_ps(meter.Squares + 8 * i);
+  }
+
+  __m256 operator()(__m256 x) {
+    x = _mm256_mul_ps(x, _mm256_add_ps(Gain, _mm256_mul_ps(Step, Index)));
+    Index = _mm256_add_ps(Index, _mm256_set1_ps(8.f));
+
+    Peak = _mm256_max_ps(_mm256_andnot_ps(_mm256_set1_ps(-0.f), x), Peak);
+
+    __m256 squares = _mm256_add_ps(Squares[0], _mm256_mul_ps(x, x));
+    Squares[0] = Squares[1];
+    Squares[1] = squares;
+    ++Calls;
+
+    return x;
+  }
+
+  void Save(MeterState& meter) const {
+    for (size_t i = 0; i < 2; ++i)
+      _mm256_storeu_ps(meter.Squares + 8 * ((Calls + i) % 2), Squares[i]);
+
+    __m128 peak = _mm_max_ps(_mm256_castps256_ps128(Peak),
+                             _mm256_extractf128_ps(Peak, 1));
+    peak = _mm_max_ps(peak, _mm_movehl_ps(peak, peak));
+    peak = _mm_max_ss(peak, _mm_shuffle_ps(peak, peak, 1));
+    meter.Peak = _mm_cvtss_f32(peak);
+  }
+};
+
+// Conversion loops. VectorLoad() passes every 8 converted floats through
+// process() before they are stored, VectorStore() turns every 8 floats
+// into what is stored with quantize(): 8 x int32 for integer formats,
+// 8 floats for float ones. Both are called in sample order
+
+template <typename T, int Bits, bool Swap, typename Process>
+size_t VectorLoad(IntFormat<T, Bits, Swap>, const void* src, float* dst,
+                  size_t size, Process& process) {
+  using Format = IntFormat<T, Bits, Swap>;
+
+  auto in = static_cast<const T*>(src);
+  const __m256 scale = _mm256_set1_ps(Format::ToFloatScale);
+  size_t i = 0;
+
+  for (; i + 8 <= size; i += 8) {
+    __m256i val;
+
+    if constexpr (sizeof(T) == 4) {
+      val = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+      if constexpr (Swap) val = Reverse<4>(val);
+      if constexpr (Format::Shift > 0)
+        val = _mm256_srai_epi32(_mm256_slli_epi32(val, Format::Shift),
+                                Format::Shift);
+    } else {
+      __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+      if constexpr (Swap)
+        raw = _mm_or_si128(_mm_slli_epi16(raw, 8), _mm_srli_epi16(raw, 8));
+      val = _mm256_cvtepi16_epi32(raw);
+    }
+
+    __m256 x = _mm256_mul_ps(_mm256_cvtepi32_ps(val), scale);
+    _mm256_storeu_ps(dst + i, process(x));
+  }
+
+  return i;
+}
+
+template <typename T, int Bits, bool Swap, typename Quantizer>
+size_t VectorStore(IntFormat<T, Bits, Swap>, const float* src, void* dst,
+                   size_t size, Quantizer& quantize) {
+  auto out = static_cast<T*>(dst);
+  size_t i = 0;
+
+  if constexpr (sizeof(T) == 4) {
+    for (; i + 8 <= size; i += 8) {
+      __m256i val = quantize(_mm256_loadu_ps(src + i));
+      if constexpr (Swap) val = Reverse<4>(val);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), val);
+    }
+  } else {
+    for (; i + 16 <= size; i += 16) {
+      __m256i lo = quantize(_mm256_loadu_ps(src + i));
+      __m256i hi = quantize(_mm256_loadu_ps(src + i + 8));
+
+      // packs works within 128-bit lanes, put the quarters back in order
+      __m256i val = _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi),
+                                             _MM_SHUFFLE(3, 1, 2, 0));
+      if constexpr (Swap) val = Reverse<2>(val);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), val);
+    }
+  }
+
+  return i;
+}
+
+// Packed 24-bit samples are spread over the top bytes of 32-bit lanes
+// with one shuffle per 128-bit lane, 4 samples each. Loads and stores
+// are 32 bytes wide, so the loops stop before they could touch memory
+// past the 24 bytes of the last 8 samples
+template <bool Swap, typename Process>
+size_t VectorLoad(Int24Format<Swap>, const void* src, float* dst, size_t size,
+                  Process& process) {
+  auto in = static_cast<const uint8_t*>(src);
+  const __m256 scale = _mm256_set1_ps(Int24Format<Swap>::ToFloatScale);
+  const __m256i spread = _mm256_setr_epi32(0, 1, 2, 3, 3, 4, 5, 6);
+
+  // -1 zeroes the byte
+  const __m256i unpack =
+      Swap ? _mm256_setr_epi8(-1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11,
+                              10, 9, -1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1,
+                              11, 10, 9)
+           : _mm256_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10,
+                              11, -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9,
+                              10, 11);
+  size_t i = 0;
+
+  for (; i + 11 <= size; i += 8) {
+    __m256i raw =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 3 * i));
+    raw = _mm256_permutevar8x32_epi32(raw, spread);
+
+    __m256i val = _mm256_srai_epi32(_mm256_shuffle_epi8(raw, unpack), 8);
+    __m256 x = _mm256_mul_ps(_mm256_cvtepi32_ps(val), scale);
+    _mm256_storeu_ps(dst + i, process(x));
+  }
+
+  return i;
+}
+
+template <bool Swap, typename Quantizer>
+size_t VectorStore(Int24Format<Swap>, const float* src, void* dst, size_t size,
+                   Quantizer& quantize) {
+  auto out = static_cast<uint8_t*>(dst);
+  const __m256i gather = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+
+  const __m256i pack =
+      Swap ? _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1,
+                              -1, -1, 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+                              -1, -1, -1, -1)
+           : _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1,
+                              -1, -1, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14,
+                              -1, -1, -1, -1);
+  size_t i = 0;
+
+  for (; i + 11 <= size; i += 8) {
+    __m256i val = quantize(_mm256_loadu_ps(src + i));
+    val = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(val, pack), gather);
+
+    // The top 8 bytes are overwritten by the next iteration or the tail
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 3 * i), val);
+  }
+
+  return i;
+}
+
+template <bool Swap, typename Process>
+size_t VectorLoad(FloatFormat<float, Swap>, const void* src, float* dst,
+                  size_t size, Process& process) {
+  auto in = static_cast<const float*>(src);
+  size_t i = 0;
+
+  for (; i + 8 <= size; i += 8) {
+    __m256i val = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+    if constexpr (Swap) val = Reverse<4>(val);
+    _mm256_storeu_ps(dst + i, process(_mm256_castsi256_ps(val)));
+  }
+
+  return i;
+}
+
+template <bool Swap, typename Process>
+size_t VectorStore(FloatFormat<float, Swap>, const float* src, void* dst,
+                   size_t size, Process& process) {
+  auto out = static_cast<float*>(dst);
+  size_t i = 0;
+
+  for (; i + 8 <= size; i += 8) {
+    __m256i val = _mm256_castps_si256(process(_mm256_loadu_ps(src + i)));
+    if constexpr (Swap) val = Reverse<4>(val);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), val);
+  }
+
+  return i;
+}
+
+template <bool Swap, typename Process>
+size_t VectorLoad(FloatFormat<double, Swap>, const void* src, float* dst,
+                  size_t size, Process& process) {
+  auto in = static_cast<const double*>(src);
+  size_t i = 0;
+
+  for (; i + 8 <= size; i += 8) {
+    __m256d lo = _mm256_loadu_pd(in + i);
+    __m256d hi = _mm256_loadu_pd(in + i + 4);
+
+    if constexpr (Swap) {
+      lo = _mm256_castsi256_pd(Reverse<8>(_mm256_castpd_si256(lo)));
+      hi = _mm256_castsi256_pd(Reverse<8>(_mm256_castpd_si256(hi)));
+    }
+
+    __m256 val = _mm256_set_m128(_mm256_cvtpd_ps(hi), _mm256_cvtpd_ps(lo));
+    _mm256_storeu_ps(dst + i, process(val));
+  }
+
+  return i;
+}
+
+template <bool Swap, typename Process>
+size_t VectorStore(FloatFormat<double, Swap>, const float* src, void* dst,
+                   size_t size, Process& process) {
+  auto out = static_cast<double*>(dst);
+  size_t i = 0;
+
+  for (; i + 8 <= size; i += 8) {
+    __m256 val = process(_mm256_loadu_ps(src + i));
+    __m256d lo = _mm256_cvtps_pd(_mm256_castps256_ps128(val));
+    __m256d hi = _mm256_cvtps_pd(_mm256_extractf128_ps(val, 1));
+
+    if constexpr (Swap) {
+      lo = _mm256_castsi256_pd(Reverse<8>(_mm256_castpd_si256(lo)));
+      hi = _mm256_castsi256_pd(Reverse<8>(_mm256_castpd_si256(hi)));
+    }
+
+    _mm256_storeu_pd(out + i, lo);
+    _mm256_storeu_pd(out + i + 4, hi);
+  }
+
+  return i;
+}
+
+// The kernels declared in KernelsImpl.hpp, built from the loops above
+
+template <typename Format>
+size_t VectorToFloat(Format format, const void* src, float* dst, size_t size) {
+  auto unity = [](__m256 x) { return x; };
+  return VectorLoad(format, src, dst, size, unity);
+}
+
+template <typename Format>
+size_t VectorFromFloat(Format format, const float* src, void* dst,
+                       size_t size) {
+  if constexpr (IsFloat<Format>) {
+    auto unity = [](__m256 x) { return x; };
+    return VectorStore(format, src, dst, size, unity);
+  } else {
+    const __m256d scale = _mm256_set1_pd(Format::FromFloatScale);
+    auto quantize = [scale](__m256 x) { return Quantize(x, scale); };
+    return VectorStore(format, src, dst, size, quantize);
+  }
+}
+
+template <DitherMode Mode, typename Format>
+size_t VectorDither(Format format, const float* src, void* dst, size_t size,
+                    DitherState& state) {
+  Ditherer<Mode> quantize{state, float(Format::Max)};
+  size_t done = VectorStore(format, src, dst, size, quantize);
+  quantize.Save(state);
+  return done;
+}
+
+template <typename Format>
+size_t VectorToFloatGain(Format format, const void* src, float* dst,
+                         size_t size, float gain, float step,
+                         MeterState& meter) {
+  VectorStrip strip{gain, step, meter};
+  size_t done = VectorLoad(format, src, dst, size, strip);
+  strip.Save(meter);
+  return done;
+}
+
+template <DitherMode Mode, typename Format>
+size_t VectorFromFloatGain(Format format, const float* src, void* dst,
+                           size_t size, float gain, float step,
+                           MeterState& meter, DitherState& dither) {
+  VectorStrip strip{gain, step, meter};
+  size_t done;
+
+  if constexpr (IsFloat<Format>) {
+    done = VectorStore(format, src, dst, size, strip);
+  } else if constexpr (IsDithered<Format>) {
+    Ditherer<Mode> ditherer{dither, float(Format::Max)};
+    auto quantize = [&](__m256 x) { return ditherer(strip(x)); };
+    done = VectorStore(format, src, dst, size, quantize);
+    ditherer.Save(dither);
+  } else {
+    const __m256d scale = _mm256_set1_pd(Format::FromFloatScale);
+    auto quantize = [&](__m256 x) { return Quantize(strip(x), scale); };
+    done = VectorStore(format, src, dst, size, quantize);
+  }
+
+  strip.Save(meter);
+  return done;
+}
+
+size_t VectorMix(const float* src, float* dst, float gain, size_t size) {
+  const __m256 g = _mm256_set1_ps(gain);
+  size_t i = 0;
+
+  for (; i + 8 <= size; i += 8) {
+    __m256 val = _mm256_mul_ps(_mm256_loadu_ps(src + i), g);
+    _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), val));
+  }
+
+  return i;
+}
+
+size_t VectorGain(const float* src, float* dst, float gain, size_t size) {
+  const __m256 g = _mm256_set1_ps(gain);
+  size_t i = 0;
+
+  for (; i + 8 <= size; i += 8)
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(src + i), g));
+
+  return i;
+}
+
+size_t VectorPeak(const float* src, size_t size, float& peak) {
+  const __m256 sign = _mm256_set1_ps(-0.f);
+  __m256 acc = _mm256_set1_ps(peak);
+  size_t i = 0;
+
+  for (; i + 8 <= size; i += 8)
+    acc = _mm256_max_ps(_mm256_andnot_ps(sign, _mm256_loadu_ps(src + i)), acc);
+
+  __m128 half = _mm_max_ps(_mm256_castps256_ps128(acc),
+                           _mm256_extractf128_ps(acc, 1));
+  half = _mm_max_ps(half, _mm_movehl_ps(half, half));
+  half = _mm_max_ss(half, _mm_shuffle_ps(half, half, 1));
+  peak = _mm_cvtss_f32(half);
+
+  return i;
+}
+
+}  // namespace
+
+constinit const KernelTable Avx2Kernels = MakeKernelTable<CpuTier::Avx2>();
+
+}  // namespace Helpers
+}  // namespace GigOn
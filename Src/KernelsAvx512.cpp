@@ -0,0 +1,429 @@
+#include <immintrin.h>
+
+#include "KernelsImpl.hpp"
+
+// Compiled with -mavx512f -mavx512bw, only called when the CPU has both
+
+namespace GigOn {
+namespace Helpers {
+
+namespace {
+
+// Reverses the bytes of every Width-byte element
+template <int Width>
+__m512i Reverse(__m512i x) {
+  if constexpr (Width == 2)
+    return _mm512_or_si512(_mm512_slli_epi16(x, 8), _mm512_srli_epi16(x, 8));
+
+  const __m128i mask =
+      Width == 4 ? _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14,
+                                 13, 12)
+                 : _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11,
+                                 10, 9, 8);
+  return _mm512_shuffle_epi8(x, _mm512_broadcast_i32x4(mask));
+}
+
+inline __m256i Reverse16(__m256i x) {
+  return _mm256_or_si256(_mm256_slli_epi16(x, 8), _mm256_srli_epi16(x, 8));
+}
+
+// 16 floats -> 16 x int32, see Quantize()
+inline __m512i Quantize(__m512 x, __m512d scale) {
+  x = _mm512_max_ps(x, _mm512_set1_ps(-1.f));
+  x = _mm512_min_ps(x, _mm512_set1_ps(1.f));
+
+  __m256 upper = _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(x), 1));
+  __m512d lo = _mm512_cvtps_pd(_mm512_castps512_ps256(x));
+  __m512d hi = _mm512_cvtps_pd(upper);
+
+  __m256i first = _mm512_cvttpd_epi32(_mm512_mul_pd(lo, scale));
+  __m256i second = _mm512_cvttpd_epi32(_mm512_mul_pd(hi, scale));
+  return _mm512_inserti64x4(_mm512_castsi256_si512(first), second, 1);
+}
+
+// 16 floats -> 16 x int32 with dither, see QuantizeDithered().
+// One register holds all the generator lanes of a DitherState
+template <DitherMode Mode>
+struct Ditherer {
+  __m512i Random;
+  __m512 Last;
+  __m512 Max;
+  __m512 Min;
+
+  Ditherer(const DitherState& state, float max)
+      : Random{_mm512_loadu_si512(state.Random)},
+        Last{_mm512_set1_ps(state.Last)},
+        Max{_mm512_set1_ps(max)},
+        Min{_mm512_set1_ps(-max - 1.f)} {}
+
+  __m512i operator()(__m512 x) {
+    __m512 dither = _mm512_setzero_ps();
+
+    if constexpr (Mode != DitherMode::None) {
+      __m512i r = Random;
+      r = _mm512_xor_si512(r, _mm512_slli_epi32(r, 13));
+      r = _mm512_xor_si512(r, _mm512_srli_epi32(r, 17));
+      r = _mm512_xor_si512(r, _mm512_slli_epi32(r, 5));
+      Random = r;
+
+      if constexpr (Mode == DitherMode::Tpdf) {
+        __m512i diff =
+            _mm512_sub_epi32(_mm512_and_si512(r, _mm512_set1_epi32(0xffff)),
+                             _mm512_srli_epi32(r, 16));
+        dither = _mm512_mul_ps(_mm512_cvtepi32_ps(diff),
+                               _mm512_set1_ps(1.f / 65536));
+      } else {
+        __m512 uniform =
+            _mm512_mul_ps(_mm512_cvtepi32_ps(r), _mm512_set1_ps(0x1p-32f));
+
+        // Previous draw of every lane: shift in the last one of the call before
+        __m512i prev = _mm512_alignr_epi32(_mm512_castps_si512(uniform),
+                                           _mm512_castps_si512(Last), 15);
+        dither = _mm512_sub_ps(uniform, _mm512_castsi512_ps(prev));
+        Last = uniform;
+      }
+    }
+
+    x = _mm512_add_ps(_mm512_mul_ps(x, Max), dither);
+    x = _mm512_min_ps(_mm512_max_ps(x, Min), Max);
+    return _mm512_cvtps_epi32(x);
+  }
+
+  void Save(DitherState& state) const {
+    _mm512_storeu_si512(state.Random, Random);
+    state.Last = _mm512_cvtss_f32(
+        _mm512_permutexvar_ps(_mm512_set1_epi32(15), Last));
+  }
+};
+
+// Gain ramp and meter of the fused kernels for 16 samples at a time,
+// see Strip. One register holds all the partial sums
+struct VectorStrip {
+  __m512 Gain;
+  __m512 Step;
+  __m512 Index;
+  __m512 Peak;
+  __m512 Squares;
+
+  VectorStrip(float gain, float step, const MeterState& meter)
+      : Gain{_mm512_set1_ps(gain)},
+        Step{_mm512_set1_ps(step)},
+        Index{_mm512_setr_ps(1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f,
+                             10.f, 11.f, 12.f, 13.f, 14.f, 15.f, 16.f)},
+        Peak{_mm512_set1_ps(meter.Peak)},
+        Squares{_mm512_loadu_ps(meter.Squares)} {}
+
+  __m512 operator()(__m512 x) {
+    x = _mm512_mul_ps(x, _mm512_add_ps(Gain, _mm512_mul_ps(Step, Index)));
+    Index = _mm512_add_ps(Index, _mm512_set1_ps(16.f));
+
+    Peak = _mm512_max_ps(_mm512_abs_ps(x), Peak);
+    Squares = _mm512_add_ps(Squares, _mm512_mul_ps(x, x));
+
+    return x;
+  }
+
+  void Save(MeterState& meter) const {
+    _mm512_storeu_ps(meter.Squares, Squares);
+    meter.Peak = _mm512_reduce_max_ps(Peak);
+  }
+};
+
+// Conversion loops. VectorLoad() passes every 16 converted floats through
+// process() before they are stored, VectorStore() turns every 16 floats
+// into what is stored with quantize(): 16 x int32 for integer formats,
+// 16 floats for float ones. Both are called in sample order
+
+template <typename T, int Bits, bool Swap, typename Process>
+size_t VectorLoad(IntFormat<T, Bits, Swap>, const void* src, float* dst,
+                  size_t size, Process& process) {
+  using Format = IntFormat<T, Bits, Swap>;
+
+  auto in = static_cast<const T*>(src);
+  const __m512 scale = _mm512_set1_ps(Format::ToFloatScale);
+  size_t i = 0;
+
+  for (; i + 16 <= size; i += 16) {
+    __m512i val;
+
+    if constexpr (sizeof(T) == 4) {
+      val = _mm512_loadu_si512(in + i);
+      if constexpr (Swap) val = Reverse<4>(val);
+      if constexpr (Format::Shift > 0)
+        val = _mm512_srai_epi32(_mm512_slli_epi32(val, Format::Shift),
+                                Format::Shift);
+    } else {
+      __m256i raw =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+      if constexpr (Swap) raw = Reverse16(raw);
+      val = _mm512_cvtepi16_epi32(raw);
+    }
+
+    __m512 x = _mm512_mul_ps(_mm512_cvtepi32_ps(val), scale);
+    _mm512_storeu_ps(dst + i, process(x));
+  }
+
+  return i;
+}
+
+template <typename T, int Bits, bool Swap, typename Quantizer>
+size_t VectorStore(IntFormat<T, Bits, Swap>, const float* src, void* dst,
+                   size_t size, Quantizer& quantize) {
+  auto out = static_cast<T*>(dst);
+  size_t i = 0;
+
+  for (; i + 16 <= size; i += 16) {
+    __m512i val = quantize(_mm512_loadu_ps(src + i));
+
+    if constexpr (sizeof(T) == 4) {
+      if constexpr (Swap) val = Reverse<4>(val);
+      _mm512_storeu_si512(out + i, val);
+    } else {
+      __m256i narrow = _mm512_cvtsepi32_epi16(val);
+      if constexpr (Swap) narrow = Reverse16(narrow);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), narrow);
+    }
+  }
+
+  return i;
+}
+
+// Packed 24-bit samples: 16 of them fill 12 of the 16 dwords. Masked
+// loads and stores touch exactly those, so nothing past the buffer is
+// read or written
+constexpr __mmask16 Int24Dwords = 0x0fff;
+
+template <bool Swap, typename Process>
+size_t VectorLoad(Int24Format<Swap>, const void* src, float* dst, size_t size,
+                  Process& process) {
+  auto in = static_cast<const uint8_t*>(src);
+  const __m512 scale = _mm512_set1_ps(Int24Format<Swap>::ToFloatScale);
+  const __m512i spread = _mm512_setr_epi32(0, 1, 2, 3, 3, 4, 5, 6, 6, 7, 8,
+                                           9, 9, 10, 11, 12);
+
+  // -1 zeroes the byte
+  const __m128i lane =
+      Swap ? _mm_setr_epi8(-1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9)
+           : _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+  const __m512i unpack = _mm512_broadcast_i32x4(lane);
+  size_t i = 0;
+
+  for (; i + 16 <= size; i += 16) {
+    __m512i raw = _mm512_maskz_loadu_epi32(Int24Dwords, in + 3 * i);
+    raw = _mm512_permutexvar_epi32(spread, raw);
+
+    __m512i val = _mm512_srai_epi32(_mm512_shuffle_epi8(raw, unpack), 8);
+    __m512 x = _mm512_mul_ps(_mm512_cvtepi32_ps(val), scale);
+    _mm512_storeu_ps(dst + i, process(x));
+  }
+
+  return i;
+}
+
+template <bool Swap, typename Quantizer>
+size_t VectorStore(Int24Format<Swap>, const float* src, void* dst, size_t size,
+                   Quantizer& quantize) {
+  auto out = static_cast<uint8_t*>(dst);
+  const __m512i gather = _mm512_setr_epi32(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13,
+                                           14, 15, 15, 15, 15);
+
+  const __m128i lane =
+      Swap ? _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1,
+                           -1)
+           : _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1,
+                           -1);
+  const __m512i pack = _mm512_broadcast_i32x4(lane);
+  size_t i = 0;
+
+  for (; i + 16 <= size; i += 16) {
+    __m512i val = quantize(_mm512_loadu_ps(src + i));
+    val = _mm512_permutexvar_epi32(gather, _mm512_shuffle_epi8(val, pack));
+    _mm512_mask_storeu_epi32(out + 3 * i, Int24Dwords, val);
+  }
+
+  return i;
+}
+
+template <bool Swap, typename Process>
+size_t VectorLoad(FloatFormat<float, Swap>, const void* src, float* dst,
+                  size_t size, Process& process) {
+  auto in = static_cast<const float*>(src);
+  size_t i = 0;
+
+  for (; i + 16 <= size; i += 16) {
+    __m512i val = _mm512_loadu_si512(in + i);
+    if constexpr (Swap) val = Reverse<4>(val);
+    _mm512_storeu_ps(dst + i, process(_mm512_castsi512_ps(val)));
+  }
+
+  return i;
+}
+
+template <bool Swap, typename Process>
+size_t VectorStore(FloatFormat<float, Swap>, const float* src, void* dst,
+                   size_t size, Process& process) {
+  auto out = static_cast<float*>(dst);
+  size_t i = 0;
+
+  for (; i + 16 <= size; i += 16) {
+    __m512i val = _mm512_castps_si512(process(_mm512_loadu_ps(src + i)));
+    if constexpr (Swap) val = Reverse<4>(val);
+    _mm512_storeu_si512(out + i, val);
+  }
+
+  return i;
+}
+
+template <bool Swap, typename Process>
+size_t VectorLoad(FloatFormat<double, Swap>, const void* src, float* dst,
+                  size_t size, Process& process) {
+  auto in = static_cast<const double*>(src);
+  size_t i = 0;
+
+  for (; i + 16 <= size; i += 16) {
+    __m512d lo = _mm512_loadu_pd(in + i);
+    __m512d hi = _mm512_loadu_pd(in + i + 8);
+
+    if constexpr (Swap) {
+      lo = _mm512_castsi512_pd(Reverse<8>(_mm512_castpd_si512(lo)));
+      hi = _mm512_castsi512_pd(Reverse<8>(_mm512_castpd_si512(hi)));
+    }
+
+    __m512d val = _mm512_castps_pd(_mm512_castps256_ps512(_mm512_cvtpd_ps(lo)));
+    val = _mm512_insertf64x4(val, _mm256_castps_pd(_mm512_cvtpd_ps(hi)), 1);
+    _mm512_storeu_ps(dst + i, process(_mm512_castpd_ps(val)));
+  }
+
+  return i;
+}
+
+template <bool Swap, typename Process>
+size_t VectorStore(FloatFormat<double, Swap>, const float* src, void* dst,
+                   size_t size, Process& process) {
+  auto out = static_cast<double*>(dst);
+  size_t i = 0;
+
+  for (; i + 16 <= size; i += 16) {
+    __m512 val = process(_mm512_loadu_ps(src + i));
+    __m256 upper =
+        _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(val), 1));
+
+    __m512d lo = _mm512_cvtps_pd(_mm512_castps512_ps256(val));
+    __m512d hi = _mm512_cvtps_pd(upper);
+
+    if constexpr (Swap) {
+      lo = _mm512_castsi512_pd(Reverse<8>(_mm512_castpd_si512(lo)));
+      hi = _mm512_castsi512_pd(Reverse<8>(_mm512_castpd_si512(hi)));
+    }
+
+    _mm512_storeu_pd(out + i, lo);
+    _mm512_storeu_pd(out + i + 8, hi);
+  }
+
+  return i;
+}
+
+// The kernels declared in KernelsImpl.hpp, built from the loops above
+
+template <typename Format>
+size_t VectorToFloat(Format format, const void* src, float* dst, size_t size) {
+  auto unity = [](__m512 x) { return x; };
+  return VectorLoad(format, src, dst, size, unity);
+}
+
+template <typename Format>
+size_t VectorFromFloat(Format format, const float* src, void* dst,
+                       size_t size) {
+  if constexpr (IsFloat<Format>) {
+    auto unity = [](__m512 x) { return x; };
+    return VectorStore(format, src, dst, size, unity);
+  } else {
+    const __m512d scale = _mm512_set1_pd(Format::FromFloatScale);
+    auto quantize = [scale](__m512 x) { return Quantize(x, scale); };
+    return VectorStore(format, src, dst, size, quantize);
+  }
+}
+
+template <DitherMode Mode, typename Format>
+size_t VectorDither(Format format, const float* src, void* dst, size_t size,
+                    DitherState& state) {
+  Ditherer<Mode> quantize{state, float(Format::Max)};
+  size_t done = VectorStore(format, src, dst, size, quantize);
+  quantize.Save(state);
+  return done;
+}
+
+template <typename Format>
+size_t VectorToFloatGain(Format format, const void* src, float* dst,
+                         size_t size, float gain, float step,
+                         MeterState& meter) {
+  VectorStrip strip{gain, step, meter};
+  size_t done = VectorLoad(format, src, dst, size, strip);
+  strip.Save(meter);
+  return done;
+}
+
+template <DitherMode Mode, typename Format>
+size_t VectorFromFloatGain(Format format, const float* src, void* dst,
+                           size_t size, float gain, float step,
+                           MeterState& meter, DitherState& dither) {
+  VectorStrip strip{gain, step, meter};
+  size_t done;
+
+  if constexpr (IsFloat<Format>) {
+    done = VectorStore(format, src, dst, size, strip);
+  } else if constexpr (IsDithered<Format>) {
+    Ditherer<Mode> ditherer{dither, float(Format::Max)};
+    auto quantize = [&](__m512 x) { return ditherer(strip(x)); };
+    done = VectorStore(format, src, dst, size, quantize);
+    ditherer.Save(dither);
+  } else {
+    const __m512d scale = _mm512_set1_pd(Format::FromFloatScale);
+    auto quantize = [&](__m512 x) { return Quantize(strip(x), scale); };
+    done = VectorStore(format, src, dst, size, quantize);
+  }
+
+  strip.Save(meter);
+  return done;
+}
+
+size_t VectorMix(const float* src, float* dst, float gain, size_t size) {
+  const __m512 g = _mm512_set1_ps(gain);
+  size_t i = 0;
+
+  for (; i + 16 <= size; i += 16) {
+    __m512 val = _mm512_mul_ps(_mm512_loadu_ps(src + i), g);
+    _mm512_storeu_ps(dst + i, _mm512_add_ps(_mm512_loadu_ps(dst + i), val));
+  }
+
+  return i;
+}
+
+size_t VectorGain(const float* src, float* dst, float gain, size_t size) {
+  const __m512 g = _mm512_set1_ps(gain);
+  size_t i = 0;
+
+  for (; i + 16 <= size; i += 16)
+    _mm512_storeu_ps(dst + i, _mm512_mul_ps(_mm512_loadu_ps(src + i), g));
+
+  return i;
+}
+
+size_t VectorPeak(const float* src, size_t size, float& peak) {
+  __m512 acc = _mm512_set1_ps(peak);
+  size_t i = 0;
+
+  for (; i + 16 <= size; i += 16)
+    acc = _mm512_max_ps(_mm512_abs_ps(_mm512_loadu_ps(src + i)), acc);
+
+  peak = _mm512_reduce_max_ps(acc);
+  return i;
+}
+
+}  // namespace
+
+constinit const KernelTable Avx512Kernels =
+    MakeKernelTable<CpuTier::Avx512>();
+
+}  // namespace Helpers
+}  // namespace GigOn
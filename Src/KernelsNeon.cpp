@@ -0,0 +1,432 @@
+#include <arm_neon.h>
+
+#include "KernelsImpl.hpp"
+
+// AArch64 kernels, NEON is always there
+
+namespace GigOn {
+namespace Helpers {
+
+namespace {
+
+// Reverses the bytes of every Width-byte element
+template <int Width>
+uint8x16_t Reverse(uint8x16_t x) {
+  if constexpr (Width == 2) return vrev16q_u8(x);
+  if constexpr (Width == 4) return vrev32q_u8(x);
+  return vrev64q_u8(x);
+}
+
+// 4 floats -> 4 x int32, see Quantize(). maxnm/minnm turn NaN
+// into -1 like the scalar code does
+inline int32x4_t Quantize(float32x4_t x, double scale) {
+  x = vmaxnmq_f32(x, vdupq_n_f32(-1.f));
+  x = vminnmq_f32(x, vdupq_n_f32(1.f));
+
+  float64x2_t lo = vmulq_n_f64(vcvt_f64_f32(vget_low_f32(x)), scale);
+  float64x2_t hi = vmulq_n_f64(vcvt_high_f64_f32(x), scale);
+
+  return vcombine_s32(vmovn_s64(vcvtq_s64_f64(lo)),
+                      vmovn_s64(vcvtq_s64_f64(hi)));
+}
+
+// 4 floats -> 4 x int32 with dither, see QuantizeDithered(). Holds
+// the 16 generator lanes of a DitherState in 4 registers and rotates
+// them after each call, so the n-th call draws lanes 4 * (n % 4) on:
+// sample i gets lane i % 16 as long as calls come in sample order
+template <DitherMode Mode>
+struct Ditherer {
+  uint32x4_t Random[4];
+  float32x4_t Last;
+  float Max;
+  float Min;
+  size_t Calls = 0;
+
+  Ditherer(const DitherState& state, float max)
+      : Last{vdupq_n_f32(state.Last)}, Max{max}, Min{-max - 1.f} {
+    for (size_t i = 0; i < 4; ++i) Random[i] = vld1q_u32(state.Random + 4 * i);
+  }
+
+  int32x4_t operator()(float32x4_t x) {
+    float32x4_t dither = vdupq_n_f32(0.f);
+
+    if constexpr (Mode != DitherMode::None) {
+      uint32x4_t r = Random[0];
+      r = veorq_u32(r, vshlq_n_u32(r, 13));
+      r = veorq_u32(r, vshrq_n_u32(r, 17));
+      r = veorq_u32(r, vshlq_n_u32(r, 5));
+
+      Random[0] = Random[1];
+      Random[1] = Random[2];
+      Random[2] = Random[3];
+      Random[3] = r;
+      ++Calls;
+
+      if constexpr (Mode == DitherMode::Tpdf) {
+        int32x4_t diff =
+            vsubq_s32(vreinterpretq_s32_u32(vandq_u32(r, vdupq_n_u32(0xffff))),
+                      vreinterpretq_s32_u32(vshrq_n_u32(r, 16)));
+        dither = vmulq_n_f32(vcvtq_f32_s32(diff), 1.f / 65536);
+      } else {
+        float32x4_t uniform =
+            vmulq_n_f32(vcvtq_f32_s32(vreinterpretq_s32_u32(r)), 0x1p-32f);
+
+        // Previous draw of every lane: shift in the last one of the call before
+        dither = vsubq_f32(uniform, vextq_f32(Last, uniform, 3));
+        Last = uniform;
+      }
+    }
+
+    // No fused multiply-add, see VectorMix()
+    x = vaddq_f32(vmulq_n_f32(x, Max), dither);
+    x = vminnmq_f32(vmaxnmq_f32(x, vdupq_n_f32(Min)), vdupq_n_f32(Max));
+    return vcvtnq_s32_f32(x);
+  }
+
+  void Save(DitherState& state) const {
+    for (size_t i = 0; i < 4; ++i)
+      vst1q_u32(state.Random + 4 * ((Calls + i) % 4), Random[i]);
+    state.Last = vgetq_lane_f32(Last, 3);
+  }
+};
+
+// Gain ramp and meter of the fused kernels for 4 samples at a time,
+// see Strip. The 16 partial sums rotate like the lanes of Ditherer
+struct VectorStrip {
+  float32x4_t Gain;
+  float32x4_t Step;
+  float32x4_t Index;
+  float32x4_t Peak;
+  float32x4_t Squares[4];
+  size_t Calls = 0;
+
+  VectorStrip(float gain, float step, const MeterState& meter)
+      : Gain{vdupq_n_f32(gain)},
+        Step{vdupq_n_f32(step)},
+        Peak{vdupq_n_f32(meter.Peak)} {
+    static constexpr float index[] = {1.f, 2.f, 3.f, 4.f};
+    Index = vld1q_f32(index);
+
+    for (size_t i = 0; i < 4; ++i)
+      Squares[i] = vld1q_f32(meter.Squares + 4 * i);
+  }
+
+  float32x4_t operator()(float32x4_t x) {
+    x = vmulq_f32(x, vaddq_f32(Gain, vmulq_f32(Step, Index)));
+    Index = vaddq_f32(Index, vdupq_n_f32(4.f));
+
+    // maxnm skips NaN
+    Peak = vmaxnmq_f32(vabsq_f32(x), Peak);
+
+    float32x4_t squares = vaddq_f32(Squares[0], vmulq_f32(x, x));
+    Squares[0] = Squares[1];
+    Squares[1] = Squares[2];
+    Squares[2] = Squares[3];
+    Squares[3] = squares;
+    ++Calls;
+
+    return x;
+  }
+
+  void Save(MeterState& meter) const {
+    for (size_t i = 0; i < 4; ++i)
+      vst1q_f32(meter.Squares + 4 * ((Calls + i) % 4), Squares[i]);
+    meter.Peak = vmaxnmvq_f32(Peak);
+  }
+};
+
+// Conversion loops. VectorLoad() passes every 4 converted floats through
+// process() before they are stored, VectorStore() turns every 4 floats
+// into what is stored with quantize(): 4 x int32 for integer formats,
+// 4 floats for float ones. Both are called in sample order
+
+template <typename T, int Bits, bool Swap, typename Process>
+size_t VectorLoad(IntFormat<T, Bits, Swap>, const void* src, float* dst,
+                  size_t size, Process& process) {
+  using Format = IntFormat<T, Bits, Swap>;
+
+  auto in = static_cast<const uint8_t*>(src);
+  const float scale = Format::ToFloatScale;
+  size_t i = 0;
+
+  if constexpr (sizeof(T) == 4) {
+    for (; i + 4 <= size; i += 4) {
+      uint8x16_t raw = vld1q_u8(in + 4 * i);
+      if constexpr (Swap) raw = Reverse<4>(raw);
+
+      int32x4_t val = vreinterpretq_s32_u8(raw);
+      if constexpr (Format::Shift > 0)
+        val = vshrq_n_s32(vshlq_n_s32(val, Format::Shift), Format::Shift);
+      vst1q_f32(dst + i, process(vmulq_n_f32(vcvtq_f32_s32(val), scale)));
+    }
+  } else {
+    for (; i + 8 <= size; i += 8) {
+      uint8x16_t raw = vld1q_u8(in + 2 * i);
+      if constexpr (Swap) raw = Reverse<2>(raw);
+
+      int16x8_t val = vreinterpretq_s16_u8(raw);
+      int32x4_t lo = vmovl_s16(vget_low_s16(val));
+      int32x4_t hi = vmovl_high_s16(val);
+
+      vst1q_f32(dst + i, process(vmulq_n_f32(vcvtq_f32_s32(lo), scale)));
+      vst1q_f32(dst + i + 4, process(vmulq_n_f32(vcvtq_f32_s32(hi), scale)));
+    }
+  }
+
+  return i;
+}
+
+template <typename T, int Bits, bool Swap, typename Quantizer>
+size_t VectorStore(IntFormat<T, Bits, Swap>, const float* src, void* dst,
+                   size_t size, Quantizer& quantize) {
+  auto out = static_cast<uint8_t*>(dst);
+  size_t i = 0;
+
+  if constexpr (sizeof(T) == 4) {
+    for (; i + 4 <= size; i += 4) {
+      uint8x16_t val = vreinterpretq_u8_s32(quantize(vld1q_f32(src + i)));
+      if constexpr (Swap) val = Reverse<4>(val);
+      vst1q_u8(out + 4 * i, val);
+    }
+  } else {
+    for (; i + 8 <= size; i += 8) {
+      int32x4_t lo = quantize(vld1q_f32(src + i));
+      int32x4_t hi = quantize(vld1q_f32(src + i + 4));
+
+      uint8x16_t val = vreinterpretq_u8_s16(
+          vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+      if constexpr (Swap) val = Reverse<2>(val);
+      vst1q_u8(out + 2 * i, val);
+    }
+  }
+
+  return i;
+}
+
+// Packed 24-bit samples go through a table lookup, 4 samples per
+// 16-byte load or store. The loops stop before they could touch
+// memory past the 12 bytes of the last 4 samples
+template <bool Swap, typename Process>
+size_t VectorLoad(Int24Format<Swap>, const void* src, float* dst, size_t size,
+                  Process& process) {
+  auto in = static_cast<const uint8_t*>(src);
+  const float scale = Int24Format<Swap>::ToFloatScale;
+
+  // Out of range indices zero the byte
+  static constexpr uint8_t unpackLsb[] = {255, 0, 1, 2,  255, 3,  4,  5,
+                                          255, 6, 7, 8,  255, 9,  10, 11};
+  static constexpr uint8_t unpackMsb[] = {255, 2, 1, 0,  255, 5,  4,  3,
+                                          255, 8, 7, 6,  255, 11, 10, 9};
+  const uint8x16_t unpack = vld1q_u8(Swap ? unpackMsb : unpackLsb);
+  size_t i = 0;
+
+  for (; i + 6 <= size; i += 4) {
+    uint8x16_t raw = vqtbl1q_u8(vld1q_u8(in + 3 * i), unpack);
+    int32x4_t val = vshrq_n_s32(vreinterpretq_s32_u8(raw), 8);
+    vst1q_f32(dst + i, process(vmulq_n_f32(vcvtq_f32_s32(val), scale)));
+  }
+
+  return i;
+}
+
+template <bool Swap, typename Quantizer>
+size_t VectorStore(Int24Format<Swap>, const float* src, void* dst, size_t size,
+                   Quantizer& quantize) {
+  auto out = static_cast<uint8_t*>(dst);
+
+  static constexpr uint8_t packLsb[] = {0, 1, 2,  4,  5,   6,   8,   9,
+                                        10, 12, 13, 14, 255, 255, 255, 255};
+  static constexpr uint8_t packMsb[] = {2, 1, 0,  6,  5,   4,   10,  9,
+                                        8, 14, 13, 12, 255, 255, 255, 255};
+  const uint8x16_t pack = vld1q_u8(Swap ? packMsb : packLsb);
+  size_t i = 0;
+
+  for (; i + 6 <= size; i += 4) {
+    int32x4_t val = quantize(vld1q_f32(src + i));
+
+    // The top 4 bytes are overwritten by the next iteration or the tail
+    vst1q_u8(out + 3 * i, vqtbl1q_u8(vreinterpretq_u8_s32(val), pack));
+  }
+
+  return i;
+}
+
+template <bool Swap, typename Process>
+size_t VectorLoad(FloatFormat<float, Swap>, const void* src, float* dst,
+                  size_t size, Process& process) {
+  auto in = static_cast<const uint8_t*>(src);
+  size_t i = 0;
+
+  for (; i + 4 <= size; i += 4) {
+    uint8x16_t val = vld1q_u8(in + 4 * i);
+    if constexpr (Swap) val = Reverse<4>(val);
+    vst1q_f32(dst + i, process(vreinterpretq_f32_u8(val)));
+  }
+
+  return i;
+}
+
+template <bool Swap, typename Process>
+size_t VectorStore(FloatFormat<float, Swap>, const float* src, void* dst,
+                   size_t size, Process& process) {
+  auto out = static_cast<uint8_t*>(dst);
+  size_t i = 0;
+
+  for (; i + 4 <= size; i += 4) {
+    uint8x16_t val = vreinterpretq_u8_f32(process(vld1q_f32(src + i)));
+    if constexpr (Swap) val = Reverse<4>(val);
+    vst1q_u8(out + 4 * i, val);
+  }
+
+  return i;
+}
+
+template <bool Swap, typename Process>
+size_t VectorLoad(FloatFormat<double, Swap>, const void* src, float* dst,
+                  size_t size, Process& process) {
+  auto in = static_cast<const uint8_t*>(src);
+  size_t i = 0;
+
+  for (; i + 4 <= size; i += 4) {
+    uint8x16_t lo = vld1q_u8(in + 8 * i);
+    uint8x16_t hi = vld1q_u8(in + 8 * i + 16);
+
+    if constexpr (Swap) {
+      lo = Reverse<8>(lo);
+      hi = Reverse<8>(hi);
+    }
+
+    float32x2_t first = vcvt_f32_f64(vreinterpretq_f64_u8(lo));
+    float32x4_t val = vcvt_high_f32_f64(first, vreinterpretq_f64_u8(hi));
+    vst1q_f32(dst + i, process(val));
+  }
+
+  return i;
+}
+
+template <bool Swap, typename Process>
+size_t VectorStore(FloatFormat<double, Swap>, const float* src, void* dst,
+                   size_t size, Process& process) {
+  auto out = static_cast<uint8_t*>(dst);
+  size_t i = 0;
+
+  for (; i + 4 <= size; i += 4) {
+    float32x4_t val = process(vld1q_f32(src + i));
+    uint8x16_t lo = vreinterpretq_u8_f64(vcvt_f64_f32(vget_low_f32(val)));
+    uint8x16_t hi = vreinterpretq_u8_f64(vcvt_high_f64_f32(val));
+
+    if constexpr (Swap) {
+      lo = Reverse<8>(lo);
+      hi = Reverse<8>(hi);
+    }
+
+    vst1q_u8(out + 8 * i, lo);
+    vst1q_u8(out + 8 * i + 16, hi);
+  }
+
+  return i;
+}
+
+// The kernels declared in KernelsImpl.hpp, built from the loops above
+
+template <typename Format>
+size_t VectorToFloat(Format format, const void* src, float* dst, size_t size) {
+  auto unity = [](float32x4_t x) { return x; };
+  return VectorLoad(format, src, dst, size, unity);
+}
+
+template <typename Format>
+size_t VectorFromFloat(Format format, const float* src, void* dst,
+                       size_t size) {
+  if constexpr (IsFloat<Format>) {
+    auto unity = [](float32x4_t x) { return x; };
+    return VectorStore(format, src, dst, size, unity);
+  } else {
+    const double scale = Format::FromFloatScale;
+    auto quantize = [scale](float32x4_t x) { return Quantize(x, scale); };
+    return VectorStore(format, src, dst, size, quantize);
+  }
+}
+
+template <DitherMode Mode, typename Format>
+size_t VectorDither(Format format, const float* src, void* dst, size_t size,
+                    DitherState& state) {
+  Ditherer<Mode> quantize{state, float(Format::Max)};
+  size_t done = VectorStore(format, src, dst, size, quantize);
+  quantize.Save(state);
+  return done;
+}
+
+template <typename Format>
+size_t VectorToFloatGain(Format format, const void* src, float* dst,
+                         size_t size, float gain, float step,
+                         MeterState& meter) {
+  VectorStrip strip{gain, step, meter};
+  size_t done = VectorLoad(format, src, dst, size, strip);
+  strip.Save(meter);
+  return done;
+}
+
+template <DitherMode Mode, typename Format>
+size_t VectorFromFloatGain(Format format, const float* src, void* dst,
+                           size_t size, float gain, float step,
+                           MeterState& meter, DitherState& dither) {
+  VectorStrip strip{gain, step, meter};
+  size_t done;
+
+  if constexpr (IsFloat<Format>) {
+    done = VectorStore(format, src, dst, size, strip);
+  } else if constexpr (IsDithered<Format>) {
+    Ditherer<Mode> ditherer{dither, float(Format::Max)};
+    auto quantize = [&](float32x4_t x) { return ditherer(strip(x)); };
+    done = VectorStore(format, src, dst, size, quantize);
+    ditherer.Save(dither);
+  } else {
+    const double scale = Format::FromFloatScale;
+    auto quantize = [&](float32x4_t x) { return Quantize(strip(x), scale); };
+    done = VectorStore(format, src, dst, size, quantize);
+  }
+
+  strip.Save(meter);
+  return done;
+}
+
+size_t VectorMix(const float* src, float* dst, float gain, size_t size) {
+  size_t i = 0;
+
+  // No fused multiply-add, it would round differently from the scalar tail
+  for (; i + 4 <= size; i += 4) {
+    float32x4_t val = vmulq_n_f32(vld1q_f32(src + i), gain);
+    vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), val));
+  }
+
+  return i;
+}
+
+size_t VectorGain(const float* src, float* dst, float gain, size_t size) {
+  size_t i = 0;
+
+  for (; i + 4 <= size; i += 4)
+    vst1q_f32(dst + i, vmulq_n_f32(vld1q_f32(src + i), gain));
+
+  return i;
+}
+
+size_t VectorPeak(const float* src, size_t size, float& peak) {
+  float32x4_t acc = vdupq_n_f32(peak);
+  size_t i = 0;
+
+  // maxnm skips NaN
+  for (; i + 4 <= size; i += 4)
+    acc = vmaxnmq_f32(vabsq_f32(vld1q_f32(src + i)), acc);
+
+  peak = vmaxnmvq_f32(acc);
+  return i;
+}
+
+}  // namespace
+
+constinit const KernelTable NeonKernels = MakeKernelTable<CpuTier::Neon>();
+
+}  // namespace Helpers
+}  // namespace GigOn
@@ -0,0 +1,50 @@
+#include "KernelsImpl.hpp"
+
+// Plain loops for any CPU. Built without auto-vectorization,
+// so this tier is the baseline the others are measured against
+
+namespace GigOn {
+namespace Helpers {
+
+namespace {
+
+template <typename Format>
+size_t VectorToFloat(Format, const void*, float*, size_t) {
+  return 0;
+}
+
+template <typename Format>
+size_t VectorFromFloat(Format, const float*, void*, size_t) {
+  return 0;
+}
+
+template <DitherMode Mode, typename Format>
+size_t VectorDither(Format, const float*, void*, size_t, DitherState&) {
+  return 0;
+}
+
+template <typename Format>
+size_t VectorToFloatGain(Format, const void*, float*, size_t, float, float,
+                         MeterState&) {
+  return 0;
+}
+
+template <DitherMode Mode, typename Format>
+size_t VectorFromFloatGain(Format, const float*, void*, size_t, float, float,
+                           MeterState&, DitherState&) {
+  return 0;
+}
+
+size_t VectorMix(const float*, float*, float, size_t) { return 0; }
+
+size_t VectorGain(const float*, float*, float, size_t) { return 0; }
+
+size_t VectorPeak(const float*, size_t, float&) { return 0; }
+
+}  // namespace
+
+constinit const KernelTable ScalarKernels =
+    MakeKernelTable<CpuTier::Scalar>();
+
+}  // namespace Helpers
+}  // namespace GigOn
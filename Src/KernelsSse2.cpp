@@ -0,0 +1,407 @@
+#include <emmintrin.h>
+
+#include "KernelsImpl.hpp"
+
+// Baseline x86-64 kernels. SSE2 has no byte shuffle, so packed Int24
+// is left to the scalar loops
+
+namespace GigOn {
+namespace Helpers {
+
+namespace {
+
+// Reverses the bytes of every Width-byte element. SSE2 has no byte
+// shuffle: swap the bytes within words, then the words
+template <int Width>
+__m128i Reverse(__m128i x) {
+  x = _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+  if constexpr (Width == 2) return x;
+
+  x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+  x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+  if constexpr (Width == 4) return x;
+
+  return _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+// 4 floats -> 4 x int32, see Quantize()
+inline __m128i Quantize(__m128 x, __m128d scale) {
+  x = _mm_max_ps(x, _mm_set1_ps(-1.f));
+  x = _mm_min_ps(x, _mm_set1_ps(1.f));
+
+  __m128d lo = _mm_cvtps_pd(x);
+  __m128d hi = _mm_cvtps_pd(_mm_movehl_ps(x, x));
+
+  return _mm_unpacklo_epi64(_mm_cvttpd_epi32(_mm_mul_pd(lo, scale)),
+                            _mm_cvttpd_epi32(_mm_mul_pd(hi, scale)));
+}
+
+// 4 floats -> 4 x int32 with dither, see QuantizeDithered(). Holds
+// the 16 generator lanes of a DitherState in 4 registers and rotates
+// them after each call, so the n-th call draws lanes 4 * (n % 4) on:
+// sample i gets lane i % 16 as long as calls come in sample order
+template <DitherMode Mode>
+struct Ditherer {
+  __m128i Random[4];
+  __m128 Last;
+  __m128 Max;
+  __m128 Min;
+  size_t Calls = 0;
+
+  Ditherer(const DitherState& state, float max)
+      : Last{_mm_set1_ps(state.Last)},
+        Max{_mm_set1_ps(max)},
+        Min{_mm_set1_ps(-max - 1.f)} {
+    for (size_t i = 0; i < 4; ++i)
+      Random[i] = _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(state.Random + 4 * i));
+  }
+
+  __m128i operator()(__m128 x) {
+    __m128 dither = _mm_setzero_ps();
+
+    if constexpr (Mode != DitherMode::None) {
+      __m128i r = Random[0];
+      r = _mm_xor_si128(r, _mm_slli_epi32(r, 13));
+      r = _mm_xor_si128(r, _mm_srli_epi32(r, 17));
+      r = _mm_xor_si128(r, _mm_slli_epi32(r, 5));
+
+      Random[0] = Random[1];
+      Random[1] = Random[2];
+      Random[2] = Random[3];
+      Random[3] = r;
+      ++Calls;
+
+      if constexpr (Mode == DitherMode::Tpdf) {
+        __m128i diff = _mm_sub_epi32(_mm_and_si128(r, _mm_set1_epi32(0xffff)),
+                                     _mm_srli_epi32(r, 16));
+        dither = _mm_mul_ps(_mm_cvtepi32_ps(diff), _mm_set1_ps(1.f / 65536));
+      } else {
+        __m128 uniform = _mm_mul_ps(_mm_cvtepi32_ps(r), _mm_set1_ps(0x1p-32f));
+
+        // Previous draw of every lane: shift in the last one of the call before
+        __m128i up = _mm_slli_si128(_mm_castps_si128(uniform), 4);
+        __m128i carry = _mm_srli_si128(_mm_castps_si128(Last), 12);
+        dither = _mm_sub_ps(uniform, _mm_castsi128_ps(_mm_or_si128(up, carry)));
+        Last = uniform;
+      }
+    }
+
+    x = _mm_add_ps(_mm_mul_ps(x, Max), dither);
+    x = _mm_min_ps(_mm_max_ps(x, Min), Max);
+    return _mm_cvtps_epi32(x);
+  }
+
+  void Save(DitherState& state) const {
+    for (size_t i = 0; i < 4; ++i)
+      _mm_storeu_si128(
+          reinterpret_cast<__m128i*>(state.Random + 4 * ((Calls + i) % 4)),
+          Random[i]);
+    state.Last = _mm_cvtss_f32(_mm_shuffle_ps(Last, Last, 3));
+  }
+};
+
+// Gain ramp and meter of the fused kernels for 4 samples at a time,
+// see Strip. The 16 partial sums rotate like the lanes of Ditherer
+struct VectorStrip {
+  __m128 Gain;
+  __m128 Step;
+  __m128 Index;
+  __m128 Peak;
+  __m128 Squares[4];
+  size_t Calls = 0;
+
+  VectorStrip(float gain, float step, const MeterState& meter)
+      : Gain{_mm_set1_ps(gain)},
+        Step{_mm_set1_ps(step)},
+        Index{_mm_setr_ps(1.f, 2.f, 3.f, 4.f)},
+        Peak{_mm_set1_ps(meter.Peak)} {
+    for (size_t i = 0; i < 4; ++i)
+      Squares[i] = _mm_loadu_ps(meter.Squares + 4 * i);
+  }
+
+  __m128 operator()(__m128 x) {
+    x = _mm_mul_ps(x, _mm_add_ps(Gain, _mm_mul_ps(Step, Index)));
+    Index = _mm_add_ps(Index, _mm_set1_ps(4.f));
+
+    Peak = _mm_max_ps(_mm_andnot_ps(_mm_set1_ps(-0.f), x), Peak);
+
+    __m128 squares = _mm_add_ps(Squares[0], _mm_mul_ps(x, x));
+    Squares[0] = Squares[1];
+    Squares[1] = Squares[2];
+    Squares[2] = Squares[3];
+    Squares[3] = squares;
+    ++Calls;
+
+    return x;
+  }
+
+  void Save(MeterState& meter) const {
+    for (size_t i = 0; i < 4; ++i)
+      _mm_storeu_ps(meter.Squares + 4 * ((Calls + i) % 4), Squares[i]);
+
+    __m128 peak = _mm_max_ps(Peak, _mm_movehl_ps(Peak, Peak));
+    peak = _mm_max_ss(peak, _mm_shuffle_ps(peak, peak, 1));
+    meter.Peak = _mm_cvtss_f32(peak);
+  }
+};
+
+// Conversion loops. VectorLoad() passes every 4 converted floats through
+// process() before they are stored, VectorStore() turns every 4 floats
+// into what is stored with quantize(): 4 x int32 for integer formats,
+// 4 floats for float ones. Both are called in sample order
+
+template <typename T, int Bits, bool Swap, typename Process>
+size_t VectorLoad(IntFormat<T, Bits, Swap>, const void* src, float* dst,
+                  size_t size, Process& process) {
+  using Format = IntFormat<T, Bits, Swap>;
+
+  auto in = static_cast<const T*>(src);
+  const __m128 scale = _mm_set1_ps(Format::ToFloatScale);
+  size_t i = 0;
+
+  if constexpr (sizeof(T) == 4) {
+    for (; i + 4 <= size; i += 4) {
+      __m128i val = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+      if constexpr (Swap) val = Reverse<4>(val);
+      if constexpr (Format::Shift > 0)
+        val = _mm_srai_epi32(_mm_slli_epi32(val, Format::Shift), Format::Shift);
+      _mm_storeu_ps(dst + i, process(_mm_mul_ps(_mm_cvtepi32_ps(val), scale)));
+    }
+  } else {
+    for (; i + 8 <= size; i += 8) {
+      __m128i val = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+      if constexpr (Swap) val = Reverse<2>(val);
+
+      // Sign-extend by placing the word on top and shifting it back
+      __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(val, val), 16);
+      __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(val, val), 16);
+
+      _mm_storeu_ps(dst + i, process(_mm_mul_ps(_mm_cvtepi32_ps(lo), scale)));
+      _mm_storeu_ps(dst + i + 4,
+                    process(_mm_mul_ps(_mm_cvtepi32_ps(hi), scale)));
+    }
+  }
+
+  return i;
+}
+
+template <typename T, int Bits, bool Swap, typename Quantizer>
+size_t VectorStore(IntFormat<T, Bits, Swap>, const float* src, void* dst,
+                   size_t size, Quantizer& quantize) {
+  auto out = static_cast<T*>(dst);
+  size_t i = 0;
+
+  if constexpr (sizeof(T) == 4) {
+    for (; i + 4 <= size; i += 4) {
+      __m128i val = quantize(_mm_loadu_ps(src + i));
+      if constexpr (Swap) val = Reverse<4>(val);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), val);
+    }
+  } else {
+    for (; i + 8 <= size; i += 8) {
+      __m128i lo = quantize(_mm_loadu_ps(src + i));
+      __m128i hi = quantize(_mm_loadu_ps(src + i + 4));
+
+      __m128i val = _mm_packs_epi32(lo, hi);
+      if constexpr (Swap) val = Reverse<2>(val);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), val);
+    }
+  }
+
+  return i;
+}
+
+template <bool Swap, typename Process>
+size_t VectorLoad(Int24Format<Swap>, const void*, float*, size_t, Process&) {
+  return 0;
+}
+
+template <bool Swap, typename Quantizer>
+size_t VectorStore(Int24Format<Swap>, const float*, void*, size_t,
+                   Quantizer&) {
+  return 0;
+}
+
+template <bool Swap, typename Process>
+size_t VectorLoad(FloatFormat<float, Swap>, const void* src, float* dst,
+                  size_t size, Process& process) {
+  auto in = static_cast<const float*>(src);
+  size_t i = 0;
+
+  for (; i + 4 <= size; i += 4) {
+    __m128i val = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    if constexpr (Swap) val = Reverse<4>(val);
+    _mm_storeu_ps(dst + i, process(_mm_castsi128_ps(val)));
+  }
+
+  return i;
+}
+
+template <bool Swap, typename Process>
+size_t VectorStore(FloatFormat<float, Swap>, const float* src, void* dst,
+                   size_t size, Process& process) {
+  auto out = static_cast<float*>(dst);
+  size_t i = 0;
+
+  for (; i + 4 <= size; i += 4) {
+    __m128i val = _mm_castps_si128(process(_mm_loadu_ps(src + i)));
+    if constexpr (Swap) val = Reverse<4>(val);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), val);
+  }
+
+  return i;
+}
+
+template <bool Swap, typename Process>
+size_t VectorLoad(FloatFormat<double, Swap>, const void* src, float* dst,
+                  size_t size, Process& process) {
+  auto in = static_cast<const double*>(src);
+  size_t i = 0;
+
+  for (; i + 4 <= size; i += 4) {
+    __m128d lo = _mm_loadu_pd(in + i);
+    __m128d hi = _mm_loadu_pd(in + i + 2);
+
+    if constexpr (Swap) {
+      lo = _mm_castsi128_pd(Reverse<8>(_mm_castpd_si128(lo)));
+      hi = _mm_castsi128_pd(Reverse<8>(_mm_castpd_si128(hi)));
+    }
+
+    __m128 val = _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+    _mm_storeu_ps(dst + i, process(val));
+  }
+
+  return i;
+}
+
+template <bool Swap, typename Process>
+size_t VectorStore(FloatFormat<double, Swap>, const float* src, void* dst,
+                   size_t size, Process& process) {
+  auto out = static_cast<double*>(dst);
+  size_t i = 0;
+
+  for (; i + 4 <= size; i += 4) {
+    __m128 val = process(_mm_loadu_ps(src + i));
+    __m128d lo = _mm_cvtps_pd(val);
+    __m128d hi = _mm_cvtps_pd(_mm_movehl_ps(val, val));
+
+    if constexpr (Swap) {
+      lo = _mm_castsi128_pd(Reverse<8>(_mm_castpd_si128(lo)));
+      hi = _mm_castsi128_pd(Reverse<8>(_mm_castpd_si128(hi)));
+    }
+
+    _mm_storeu_pd(out + i, lo);
+    _mm_storeu_pd(out + i + 2, hi);
+  }
+
+  return i;
+}
+
+// The kernels declared in KernelsImpl.hpp, built from the loops above
+
+template <typename Format>
+size_t VectorToFloat(Format format, const void* src, float* dst, size_t size) {
+  auto unity = [](__m128 x) { return x; };
+  return VectorLoad(format, src, dst, size, unity);
+}
+
+template <typename Format>
+size_t VectorFromFloat(Format format, const float* src, void* dst,
+                       size_t size) {
+  if constexpr (IsFloat<Format>) {
+    auto unity = [](__m128 x) { return x; };
+    return VectorStore(format, src, dst, size, unity);
+  } else {
+    const __m128d scale = _mm_set1_pd(Format::FromFloatScale);
+    auto quantize = [scale](__m128 x) { return Quantize(x, scale); };
+    return VectorStore(format, src, dst, size, quantize);
+  }
+}
+
+template <DitherMode Mode, typename Format>
+size_t VectorDither(Format format, const float* src, void* dst, size_t size,
+                    DitherState& state) {
+  Ditherer<Mode> quantize{state, float(Format::Max)};
+  size_t done = VectorStore(format, src, dst, size, quantize);
+  quantize.Save(state);
+  return done;
+}
+
+template <typename Format>
+size_t VectorToFloatGain(Format format, const void* src, float* dst,
+                         size_t size, float gain, float step,
+                         MeterState& meter) {
+  VectorStrip strip{gain, step, meter};
+  size_t done = VectorLoad(format, src, dst, size, strip);
+  strip.Save(meter);
+  return done;
+}
+
+template <DitherMode Mode, typename Format>
+size_t VectorFromFloatGain(Format format, const float* src, void* dst,
+                           size_t size, float gain, float step,
+                           MeterState& meter, DitherState& dither) {
+  VectorStrip strip{gain, step, meter};
+  size_t done;
+
+  if constexpr (IsFloat<Format>) {
+    done = VectorStore(format, src, dst, size, strip);
+  } else if constexpr (IsDithered<Format>) {
+    Ditherer<Mode> ditherer{dither, float(Format::Max)};
+    auto quantize = [&](__m128 x) { return ditherer(strip(x)); };
+    done = VectorStore(format, src, dst, size, quantize);
+    ditherer.Save(dither);
+  } else {
+    const __m128d scale = _mm_set1_pd(Format::FromFloatScale);
+    auto quantize = [&](__m128 x) { return Quantize(strip(x), scale); };
+    done = VectorStore(format, src, dst, size, quantize);
+  }
+
+  strip.Save(meter);
+  return done;
+}
+
+size_t VectorMix(const float* src, float* dst, float gain, size_t size) {
+  const __m128 g = _mm_set1_ps(gain);
+  size_t i = 0;
+
+  for (; i + 4 <= size; i += 4) {
+    __m128 val = _mm_mul_ps(_mm_loadu_ps(src + i), g);
+    _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), val));
+  }
+
+  return i;
+}
+
+size_t VectorGain(const float* src, float* dst, float gain, size_t size) {
+  const __m128 g = _mm_set1_ps(gain);
+  size_t i = 0;
+
+  for (; i + 4 <= size; i += 4)
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(src + i), g));
+
+  return i;
+}
+
+size_t VectorPeak(const float* src, size_t size, float& peak) {
+  const __m128 sign = _mm_set1_ps(-0.f);
+  __m128 acc = _mm_set1_ps(peak);
+  size_t i = 0;
+
+  for (; i + 4 <= size; i += 4)
+    acc = _mm_max_ps(_mm_andnot_ps(sign, _mm_loadu_ps(src + i)), acc);
+
+  acc = _mm_max_ps(acc, _mm_movehl_ps(acc, acc));
+  acc = _mm_max_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+  peak = _mm_cvtss_f32(acc);
+
+  return i;
+}
+
+}  // namespace
+
+constinit const KernelTable Sse2Kernels = MakeKernelTable<CpuTier::Sse2>();
+
+}  // namespace Helpers
+}  // namespace GigOn
@@ -0,0 +1,396 @@
+#include "OfflineAsioDriver.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "SampleConvert.hpp"
+
+namespace GigOn {
+
+namespace {
+
+template <typename T>
+void SplitInt64(uint64_t value, T& dst) {
+  dst.hi = static_cast<unsigned long>(value >> 32);
+  dst.lo = static_cast<unsigned long>(value & 0xFFFFFFFF);
+}
+
+}  // namespace
+
+double OfflineAsioDriver::Stats::GetRealtimeFactor(
+    ASIOSampleRate sampleRate) const {
+  using namespace std::chrono;
+
+  double elapsed = duration<double>(Elapsed).count();
+  if (elapsed <= 0) return 0;
+
+  return RenderedFrames / sampleRate / elapsed;
+}
+
+OfflineAsioDriver::OfflineAsioDriver(const Config& config) : Conf{config} {
+  constexpr auto Label = "Offline driver";
+
+  if (!Helpers::GetSampleConverter(Conf.SampleType))
+    throw std::runtime_error(std::string{Label} +
+                             ": unsupported sample type");
+
+  size_t longest = 0;
+
+  for (size_t i = 0; i < Conf.InputFiles.size(); ++i) {
+    auto& reader = Readers.emplace_back(
+        std::make_unique<WavReader>(Conf.InputFiles[i]));
+
+    // Input files can't be resampled, they must agree
+    if (i == 0)
+      Conf.SampleRate = reader->GetSampleRate();
+    else if (reader->GetSampleRate() != Conf.SampleRate)
+      throw std::runtime_error(std::string{Label} + ": " +
+                               Conf.InputFiles[i] +
+                               ": sample rate differs from the first input");
+
+    NumInputs += reader->GetChannels();
+    longest = std::max(longest, reader->GetFrames());
+  }
+
+  for (const auto& output : Conf.OutputFiles) {
+    Writers.emplace_back(std::make_unique<WavWriter>(
+        output.Path, output.NumChannels, size_t(Conf.SampleRate)));
+    NumOutputs += output.NumChannels;
+  }
+
+  TotalFrames = longest + Conf.TailFrames;
+}
+
+OfflineAsioDriver::~OfflineAsioDriver() { DisposeBuffers(); }
+
+auto OfflineAsioDriver::Wait() -> Stats {
+  std::unique_lock lock{StateMutex};
+  StateChanged.wait(lock, [this] { return Finished; });
+
+  if (Error) std::rethrow_exception(Error);
+  return RenderStats;
+}
+
+bool OfflineAsioDriver::IsFinished() {
+  std::lock_guard lock{StateMutex};
+  return Finished;
+}
+
+ASIOError OfflineAsioDriver::Init(ASIODriverInfo* info) noexcept {
+  info->driverVersion = 1;
+  std::strncpy(info->name, Name, sizeof(info->name) - 1);
+  std::strncpy(info->errorMessage, "No ASIO Driver Error",
+               sizeof(info->errorMessage) - 1);
+
+  return ASE_OK;
+}
+
+ASIOError OfflineAsioDriver::Exit() noexcept { return DisposeBuffers(); }
+
+ASIOError OfflineAsioDriver::Start() noexcept {
+  if (!Callbacks) return ASE_NotPresent;
+  if (Running.load()) return ASE_OK;
+
+  // Inputs are consumed, the render can't be repeated
+  if (IsFinished()) return ASE_InvalidMode;
+
+  Toggle = 0;
+  SamplePosition = 0;
+  SystemTime = 0;
+  Running = true;
+
+  try {
+    Worker = std::thread{&OfflineAsioDriver::RenderLoop, this};
+  } catch (...) {
+    Running = false;
+    return ASE_HWMalfunction;
+  }
+
+  return ASE_OK;
+}
+
+ASIOError OfflineAsioDriver::Stop() noexcept {
+  // Can't join itself: stopping from a callback is not allowed
+  if (Worker.get_id() == std::this_thread::get_id()) return ASE_InvalidMode;
+
+  Running = false;
+  if (Worker.joinable()) Worker.join();
+
+  return ASE_OK;
+}
+
+ASIOError OfflineAsioDriver::GetChannels(long* numInputs,
+                                         long* numOutputs) noexcept {
+  *numInputs = NumInputs;
+  *numOutputs = NumOutputs;
+  return ASE_OK;
+}
+
+ASIOError OfflineAsioDriver::GetLatencies(long* inputLatency,
+                                          long* outputLatency) noexcept {
+  // Outputs are written in the same switch the inputs are read,
+  // so rendered files are sample-aligned with the inputs
+  *inputLatency = 0;
+  *outputLatency = 0;
+  return ASE_OK;
+}
+
+ASIOError OfflineAsioDriver::GetBufferSize(long* minSize, long* maxSize,
+                                           long* prefSize,
+                                           long* granularity) noexcept {
+  *minSize = Conf.BufferInfo.MinSize;
+  *maxSize = Conf.BufferInfo.MaxSize;
+  *prefSize = Conf.BufferInfo.PrefSize;
+  *granularity = Conf.BufferInfo.Granularity;
+  return ASE_OK;
+}
+
+ASIOError OfflineAsioDriver::CanSampleRate(
+    ASIOSampleRate sampleRate) noexcept {
+  return sampleRate == Conf.SampleRate ? ASE_OK : ASE_NoClock;
+}
+
+ASIOError OfflineAsioDriver::GetSampleRate(
+    ASIOSampleRate* sampleRate) noexcept {
+  *sampleRate = Conf.SampleRate;
+  return ASE_OK;
+}
+
+ASIOError OfflineAsioDriver::SetSampleRate(
+    ASIOSampleRate sampleRate) noexcept {
+  return CanSampleRate(sampleRate);
+}
+
+ASIOError OfflineAsioDriver::GetSamplePosition(
+    ASIOSamples* samplePos, ASIOTimeStamp* timeStamp) noexcept {
+  SplitInt64(SamplePosition.load(std::memory_order_acquire), *samplePos);
+  SplitInt64(SystemTime.load(std::memory_order_acquire), *timeStamp);
+  return ASE_OK;
+}
+
+ASIOError OfflineAsioDriver::GetChannelInfo(ASIOChannelInfo* info) noexcept {
+  const auto& map = info->isInput ? InputMap : OutputMap;
+  size_t available = info->isInput ? NumInputs : NumOutputs;
+
+  if (info->channel < 0 || info->channel >= available)
+    return ASE_InvalidParameter;
+
+  bool active = info->channel < map.size() && map[info->channel];
+  auto name = std::string{info->isInput ? "File In " : "File Out "} +
+              std::to_string(info->channel);
+
+  info->isActive = active ? ASIOTrue : ASIOFalse;
+  info->channelGroup = 0;
+  info->type = Conf.SampleType;
+  std::strncpy(info->name, name.c_str(), sizeof(info->name) - 1);
+
+  return ASE_OK;
+}
+
+ASIOError OfflineAsioDriver::CreateBuffers(ASIOBufferInfo* bufferInfos,
+                                           long numChannels, long bufferSize,
+                                           ASIOCallbacks* callbacks) noexcept
+    try {
+  DisposeBuffers();
+
+  const auto& binfo = Conf.BufferInfo;
+  bool badSize = bufferSize < binfo.MinSize || bufferSize > binfo.MaxSize ||
+                 bufferSize % binfo.Granularity;
+
+  if (!callbacks || badSize) return ASE_InvalidMode;
+
+  size_t sampleSize = Helpers::GetSampleSize(Conf.SampleType);
+
+  InputMap.assign(NumInputs, nullptr);
+  OutputMap.assign(NumOutputs, nullptr);
+
+  for (long i = 0; i < numChannels; ++i) {
+    auto& info = bufferInfos[i];
+    auto& map = info.isInput ? InputMap : OutputMap;
+
+    if (info.channelNum < 0 || info.channelNum >= map.size() ||
+        map[info.channelNum]) {
+      DisposeBuffers();
+      return ASE_InvalidParameter;
+    }
+
+    auto& channel = Channels.emplace_back(std::make_unique<Channel>());
+    channel->IsInput = info.isInput;
+    channel->Number = info.channelNum;
+    channel->Storage.assign(2 * bufferSize * sampleSize, 0);
+    channel->Buffers[0] = channel->Storage.data();
+    channel->Buffers[1] = channel->Storage.data() + bufferSize * sampleSize;
+
+    map[info.channelNum] = channel.get();
+
+    info.buffers[0] = channel->Buffers[0];
+    info.buffers[1] = channel->Buffers[1];
+  }
+
+  size_t maxFileChannels = 1;
+  for (const auto& reader : Readers)
+    maxFileChannels = std::max(maxFileChannels, reader->GetChannels());
+  for (const auto& writer : Writers)
+    maxFileChannels = std::max(maxFileChannels, writer->GetChannels());
+
+  BufferSize = bufferSize;
+  Interleaved.assign(maxFileChannels * bufferSize, 0);
+  Planar.assign(bufferSize, 0);
+  Callbacks = callbacks;
+
+  TimeInfoMode =
+      Callbacks->asioMessage &&
+      Callbacks->asioMessage(kAsioSelectorSupported, kAsioSupportsTimeInfo, 0,
+                             0) &&
+      Callbacks->asioMessage(kAsioSupportsTimeInfo, 0, 0, 0);
+
+  Time = ASIOTime{};
+  Time.timeInfo.speed = 1.;
+  Time.timeInfo.sampleRate = Conf.SampleRate;
+  Time.timeInfo.flags =
+      kSystemTimeValid | kSamplePositionValid | kSampleRateValid | kSpeedValid;
+
+  return ASE_OK;
+} catch (const std::bad_alloc&) {
+  DisposeBuffers();
+  return ASE_NoMemory;
+}
+
+ASIOError OfflineAsioDriver::DisposeBuffers() noexcept {
+  Stop();
+
+  Callbacks = nullptr;
+  BufferSize = 0;
+  InputMap.clear();
+  OutputMap.clear();
+  Channels.clear();
+
+  return ASE_OK;
+}
+
+ASIOError OfflineAsioDriver::OutputReady() noexcept { return ASE_NotPresent; }
+
+ASIOError OfflineAsioDriver::Future(long selector, void* opt) noexcept {
+  switch (selector) {
+    case kAsioCanTimeInfo:
+      return ASE_SUCCESS;
+  }
+
+  return ASE_NotPresent;
+}
+
+void OfflineAsioDriver::RenderLoop() {
+  try {
+    Render();
+    Finish(nullptr);
+  } catch (...) {
+    Finish(std::current_exception());
+  }
+
+  Running = false;
+}
+
+void OfflineAsioDriver::Render() {
+  using Clock = std::chrono::steady_clock;
+
+  auto begin = Clock::now();
+  size_t rendered = 0;
+
+  while (Running.load(std::memory_order_acquire) && rendered < TotalFrames) {
+    // Virtual clock: one buffer period per switch
+    uint64_t position = SamplePosition.load(std::memory_order_acquire);
+    SystemTime.store(int64_t(position * 1e9 / Conf.SampleRate),
+                     std::memory_order_release);
+
+    ReadInputs(Toggle);
+
+    if (TimeInfoMode) {
+      GetSamplePosition(&Time.timeInfo.samplePosition,
+                        &Time.timeInfo.systemTime);
+      Callbacks->bufferSwitchTimeInfo(&Time, Toggle, ASIOTrue);
+    } else {
+      Callbacks->bufferSwitch(Toggle, ASIOTrue);
+    }
+
+    // The last block is cut to the render length
+    size_t nFrames = std::min(BufferSize, TotalFrames - rendered);
+    WriteOutputs(Toggle, nFrames);
+
+    rendered += nFrames;
+    SamplePosition.fetch_add(BufferSize, std::memory_order_acq_rel);
+    Toggle = Toggle ? 0 : 1;
+  }
+
+  std::lock_guard lock{StateMutex};
+  RenderStats.RenderedFrames = rendered;
+  RenderStats.Elapsed = Clock::now() - begin;
+}
+
+void OfflineAsioDriver::ReadInputs(long index) {
+  auto converter = Helpers::GetSampleConverter(Conf.SampleType);
+  size_t base = 0;
+
+  for (const auto& reader : Readers) {
+    size_t nChannels = reader->GetChannels();
+    size_t nFrames = reader->Read(Interleaved.data(), BufferSize);
+
+    // Shorter inputs are padded with silence
+    std::fill(Interleaved.begin() + nFrames * nChannels,
+              Interleaved.begin() + BufferSize * nChannels, 0.f);
+
+    for (size_t c = 0; c < nChannels; ++c) {
+      auto channel = InputMap[base + c];
+      if (!channel) continue;
+
+      for (size_t s = 0; s < BufferSize; ++s)
+        Planar[s] = Interleaved[s * nChannels + c];
+
+      converter->FromFloat(Planar.data(), channel->Buffers[index],
+                           BufferSize);
+    }
+
+    base += nChannels;
+  }
+}
+
+void OfflineAsioDriver::WriteOutputs(long index, size_t nFrames) {
+  auto converter = Helpers::GetSampleConverter(Conf.SampleType);
+  size_t base = 0;
+
+  for (const auto& writer : Writers) {
+    size_t nChannels = writer->GetChannels();
+
+    for (size_t c = 0; c < nChannels; ++c) {
+      auto channel = OutputMap[base + c];
+
+      // Inactive outputs are rendered as silence
+      if (channel)
+        converter->ToFloat(channel->Buffers[index], Planar.data(), nFrames);
+      else
+        std::fill(Planar.begin(), Planar.begin() + nFrames, 0.f);
+
+      for (size_t s = 0; s < nFrames; ++s)
+        Interleaved[s * nChannels + c] = Planar[s];
+    }
+
+    writer->Write(Interleaved.data(), nFrames);
+    base += nChannels;
+  }
+}
+
+void OfflineAsioDriver::Finish(std::exception_ptr error) {
+  // Files are finalized even if the render was stopped early
+  try {
+    for (auto& writer : Writers) writer->Close();
+  } catch (...) {
+    if (!error) error = std::current_exception();
+  }
+
+  std::lock_guard lock{StateMutex};
+  Finished = true;
+  Error = error;
+  StateChanged.notify_all();
+}
+
+}  // namespace GigOn
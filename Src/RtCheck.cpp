@@ -0,0 +1,173 @@
+#include "RtCheck.hpp"
+
+#ifdef GIGON_RT_CHECKS
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <dlfcn.h>
+#include <pthread.h>
+#endif
+
+namespace GigOn {
+namespace Helpers {
+
+namespace {
+thread_local unsigned RtDepth = 0;
+}
+
+RtScope::RtScope() noexcept { ++RtDepth; }
+RtScope::~RtScope() { --RtDepth; }
+
+bool InRtScope() noexcept { return RtDepth != 0; }
+
+void RtViolation(const char* what) noexcept {
+  // Leave the scope first: reporting may allocate or lock by itself
+  RtDepth = 0;
+
+  std::fputs("RT check: ", stderr);
+  std::fputs(what, stderr);
+  std::fputs(" on the real-time thread\n", stderr);
+  std::abort();
+}
+
+}  // namespace Helpers
+}  // namespace GigOn
+
+/*** Allocation traps ***/
+
+namespace {
+
+void* CheckedAlloc(std::size_t size) {
+  if (GigOn::Helpers::InRtScope())
+    GigOn::Helpers::RtViolation("heap allocation");
+
+  if (size == 0) size = 1;
+
+  void* ptr = std::malloc(size);
+  if (!ptr) throw std::bad_alloc{};
+
+  return ptr;
+}
+
+void* CheckedAlignedAlloc(std::size_t size, std::align_val_t align) {
+  if (GigOn::Helpers::InRtScope())
+    GigOn::Helpers::RtViolation("heap allocation");
+
+  auto alignment = static_cast<std::size_t>(align);
+  size = (size + alignment - 1) / alignment * alignment;
+  if (size == 0) size = alignment;
+
+#ifdef _WIN32
+  void* ptr = _aligned_malloc(size, alignment);
+#else
+  void* ptr = std::aligned_alloc(alignment, size);
+#endif
+  if (!ptr) throw std::bad_alloc{};
+
+  return ptr;
+}
+
+void CheckedFree(void* ptr) noexcept {
+  if (!ptr) return;
+
+  if (GigOn::Helpers::InRtScope())
+    GigOn::Helpers::RtViolation("heap deallocation");
+
+  std::free(ptr);
+}
+
+void CheckedAlignedFree(void* ptr) noexcept {
+  if (!ptr) return;
+
+  if (GigOn::Helpers::InRtScope())
+    GigOn::Helpers::RtViolation("heap deallocation");
+
+#ifdef _WIN32
+  _aligned_free(ptr);
+#else
+  std::free(ptr);
+#endif
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) { return CheckedAlloc(size); }
+void* operator new[](std::size_t size) { return CheckedAlloc(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept try {
+  return CheckedAlloc(size);
+} catch (...) {
+  return nullptr;
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept try {
+  return CheckedAlloc(size);
+} catch (...) {
+  return nullptr;
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+  return CheckedAlignedAlloc(size, align);
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+  return CheckedAlignedAlloc(size, align);
+}
+
+void operator delete(void* ptr) noexcept { CheckedFree(ptr); }
+void operator delete[](void* ptr) noexcept { CheckedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { CheckedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { CheckedFree(ptr); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+  CheckedAlignedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+  CheckedAlignedFree(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+  CheckedAlignedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+  CheckedAlignedFree(ptr);
+}
+
+/*** Lock traps ***/
+
+// std::mutex is built on pthread mutexes here, so interposing
+// pthread_mutex_lock catches it together with any C-level locking.
+// Windows SRW locks and critical sections can't be interposed this way,
+// there only allocations are trapped
+#ifndef _WIN32
+
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex) {
+  using LockFn = int (*)(pthread_mutex_t*);
+
+  // No guarded static here: the guard itself may take a mutex.
+  // Racing threads resolve the same symbol, relaxed is enough
+  static std::atomic<LockFn> next = nullptr;
+
+  LockFn lock = next.load(std::memory_order_relaxed);
+  if (!lock) {
+    lock = reinterpret_cast<LockFn>(dlsym(RTLD_NEXT, __func__));
+    next.store(lock, std::memory_order_relaxed);
+  }
+
+  if (GigOn::Helpers::InRtScope())
+    GigOn::Helpers::RtViolation("mutex lock");
+
+  return lock(mutex);
+}
+
+#endif
+
+#endif  // GIGON_RT_CHECKS
@@ -0,0 +1,154 @@
+#ifdef _WIN32
+// clang-format off
+#include <winsock2.h>
+#include <windows.h>
+// clang-format on
+#endif
+
+#include "SampleConvert.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include "Kernels.hpp"
+
+namespace GigOn {
+namespace Helpers {
+
+DitherState::DitherState(DitherMode mode, uint32_t seed) : Mode{mode} {
+  // Spread the seed over the lanes with the murmur3 finalizer.
+  // xorshift never leaves 0, so that one is avoided
+  for (size_t i = 0; i < Lanes; ++i) {
+    uint32_t x = seed * uint32_t(Lanes) + uint32_t(i) + 0x9e3779b9;
+    x = (x ^ (x >> 16)) * 0x85ebca6b;
+    x = (x ^ (x >> 13)) * 0xc2b2ae35;
+    x ^= x >> 16;
+    Random[i] = x ? x : 1;
+  }
+}
+
+float MeterState::GetRms() const {
+  if (Count == 0) return 0;
+
+  double sum = 0;
+  for (float squares : Squares) sum += squares;
+
+  return float(std::sqrt(sum / Count));
+}
+
+void GainRamp::SetTarget(float target, size_t length) {
+  Target = target;
+  Remaining = length;
+
+  if (length == 0) {
+    Gain = target;
+    Step = 0;
+  } else {
+    Step = (target - Gain) / float(length);
+  }
+}
+
+namespace {
+
+// Splits a buffer into the part still on the ramp and the part at the
+// target, kernel(begin, size, gain, step) runs on each
+template <typename KernelT>
+void RunRamp(GainRamp& gain, size_t size, KernelT&& kernel) {
+  size_t ramp = std::min(size, gain.Remaining);
+
+  if (ramp > 0) {
+    kernel(0, ramp, gain.Gain, gain.Step);
+
+    gain.Remaining -= ramp;
+    gain.Gain =
+        gain.Remaining ? gain.Gain + gain.Step * float(ramp) : gain.Target;
+  }
+
+  if (ramp < size) kernel(ramp, size - ramp, gain.Gain, 0.f);
+}
+
+}  // namespace
+
+void ConvertInput(const SampleConverter& converter, const void* src,
+                  float* dst, size_t size, GainRamp& gain, MeterState& meter) {
+  auto in = static_cast<const uint8_t*>(src);
+
+  RunRamp(gain, size, [&](size_t begin, size_t n, float g, float step) {
+    converter.ToFloatGain(in + begin * converter.SampleSize, dst + begin, n, g,
+                          step, meter);
+  });
+
+  meter.Count += size;
+}
+
+void ConvertOutput(const SampleConverter& converter, const float* src,
+                   void* dst, size_t size, GainRamp& gain, MeterState& meter,
+                   DitherState& dither) {
+  auto out = static_cast<uint8_t*>(dst);
+
+  RunRamp(gain, size, [&](size_t begin, size_t n, float g, float step) {
+    converter.FromFloatGain(src + begin, out + begin * converter.SampleSize, n,
+                            g, step, meter, dither);
+  });
+
+  meter.Count += size;
+}
+
+bool IsNativeFloat(ASIOSampleType type) {
+  if constexpr (std::endian::native == std::endian::little)
+    return type == ASIOSTFloat32LSB;
+  else
+    return type == ASIOSTFloat32MSB;
+}
+
+bool IsNativeDouble(ASIOSampleType type) {
+  if constexpr (std::endian::native == std::endian::little)
+    return type == ASIOSTFloat64LSB;
+  else
+    return type == ASIOSTFloat64MSB;
+}
+
+size_t GetSampleSize(ASIOSampleType type) {
+  switch (type) {
+    case ASIOSTInt16LSB:
+    case ASIOSTInt16MSB:
+      return 2;
+    case ASIOSTInt24LSB:
+    case ASIOSTInt24MSB:
+      return 3;
+    case ASIOSTInt32LSB:
+    case ASIOSTInt32MSB:
+    case ASIOSTInt32LSB16:
+    case ASIOSTInt32LSB18:
+    case ASIOSTInt32LSB20:
+    case ASIOSTInt32LSB24:
+    case ASIOSTInt32MSB16:
+    case ASIOSTInt32MSB18:
+    case ASIOSTInt32MSB20:
+    case ASIOSTInt32MSB24:
+    case ASIOSTFloat32LSB:
+    case ASIOSTFloat32MSB:
+      return 4;
+    case ASIOSTFloat64LSB:
+    case ASIOSTFloat64MSB:
+      return 8;
+    case ASIOSTDSDInt8LSB1:
+    case ASIOSTDSDInt8MSB1:
+    case ASIOSTDSDInt8NER8:
+      return 1;
+
+    default:
+      return 0;
+  }
+}
+
+const SampleConverter* GetSampleConverter(ASIOSampleType type) {
+  if (type < 0 || type >= ASIOSTLastEntry) return nullptr;
+
+  const SampleConverter& converter = GetKernels().Converters[type];
+  return converter.ToFloat ? &converter : nullptr;
+}
+
+}  // namespace Helpers
+}  // namespace GigOn
@@ -0,0 +1,118 @@
+// asiosys needs to be included first
+// clang-format off
+#include "asiosys.h"
+#include "asio.h"
+#include "asiodrivers.h"
+// clang-format on
+
+#include "SdkAsioDriver.hpp"
+
+#include <stdexcept>
+
+namespace GigOn {
+
+const size_t ASIO_DRIVER_NAME_LEN = 32;
+
+namespace {
+
+AsioDrivers& GetAsioDrivers() {
+  static AsioDrivers drivers{};
+  return drivers;
+}
+
+}  // namespace
+
+SdkAsioDriver::SdkAsioDriver(const std::string& driverName) {
+  std::string tmp = driverName;
+
+  if (!GetAsioDrivers().loadDriver(&tmp[0]))
+    throw std::runtime_error("Failed to load driver \"" + driverName + "\"");
+}
+
+SdkAsioDriver::~SdkAsioDriver() { GetAsioDrivers().removeCurrentDriver(); }
+
+std::vector<std::string> SdkAsioDriver::GetDriverNames(size_t maxNames) {
+  if (maxNames == 0) return {};
+
+  std::vector<char> buffer(ASIO_DRIVER_NAME_LEN * maxNames, 0);
+  std::vector<char*> pointers(maxNames, 0);
+
+  for (int i = 0; i < maxNames; ++i) {
+    pointers[i] = buffer.data() + i * ASIO_DRIVER_NAME_LEN;
+  }
+
+  auto drvAvailable =
+      GetAsioDrivers().getDriverNames(pointers.data(), pointers.size());
+
+  if (drvAvailable == 0) return {};
+
+  std::vector<std::string> result;
+
+  for (int i = 0; i < drvAvailable; ++i) result.emplace_back(pointers[i]);
+
+  return result;
+}
+
+ASIOError SdkAsioDriver::Init(ASIODriverInfo* info) noexcept {
+  return ASIOInit(info);
+}
+
+ASIOError SdkAsioDriver::Exit() noexcept { return ASIOExit(); }
+
+ASIOError SdkAsioDriver::Start() noexcept { return ASIOStart(); }
+ASIOError SdkAsioDriver::Stop() noexcept { return ASIOStop(); }
+
+ASIOError SdkAsioDriver::GetChannels(long* numInputs,
+                                     long* numOutputs) noexcept {
+  return ASIOGetChannels(numInputs, numOutputs);
+}
+
+ASIOError SdkAsioDriver::GetLatencies(long* inputLatency,
+                                      long* outputLatency) noexcept {
+  return ASIOGetLatencies(inputLatency, outputLatency);
+}
+
+ASIOError SdkAsioDriver::GetBufferSize(long* minSize, long* maxSize,
+                                       long* prefSize,
+                                       long* granularity) noexcept {
+  return ASIOGetBufferSize(minSize, maxSize, prefSize, granularity);
+}
+
+ASIOError SdkAsioDriver::CanSampleRate(ASIOSampleRate sampleRate) noexcept {
+  return ASIOCanSampleRate(sampleRate);
+}
+
+ASIOError SdkAsioDriver::GetSampleRate(ASIOSampleRate* sampleRate) noexcept {
+  return ASIOGetSampleRate(sampleRate);
+}
+
+ASIOError SdkAsioDriver::SetSampleRate(ASIOSampleRate sampleRate) noexcept {
+  return ASIOSetSampleRate(sampleRate);
+}
+
+ASIOError SdkAsioDriver::GetSamplePosition(ASIOSamples* samplePos,
+                                           ASIOTimeStamp* timeStamp) noexcept {
+  return ASIOGetSamplePosition(samplePos, timeStamp);
+}
+
+ASIOError SdkAsioDriver::GetChannelInfo(ASIOChannelInfo* info) noexcept {
+  return ASIOGetChannelInfo(info);
+}
+
+ASIOError SdkAsioDriver::CreateBuffers(ASIOBufferInfo* bufferInfos,
+                                       long numChannels, long bufferSize,
+                                       ASIOCallbacks* callbacks) noexcept {
+  return ASIOCreateBuffers(bufferInfos, numChannels, bufferSize, callbacks);
+}
+
+ASIOError SdkAsioDriver::DisposeBuffers() noexcept {
+  return ASIODisposeBuffers();
+}
+
+ASIOError SdkAsioDriver::OutputReady() noexcept { return ASIOOutputReady(); }
+
+ASIOError SdkAsioDriver::Future(long selector, void* opt) noexcept {
+  return ASIOFuture(selector, opt);
+}
+
+}  // namespace GigOn
@@ -0,0 +1,412 @@
+#include "SimAsioDriver.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <string>
+
+#include "SampleConvert.hpp"
+
+namespace GigOn {
+
+namespace {
+
+const ASIOSampleRate SUPPORTED_RATES[] = {44100,  48000,  88200,
+                                          96000, 176400, 192000};
+
+const double TONE_BASE_FREQ = 440;
+const float TONE_AMPLITUDE = 0.5;
+
+// Copies size bytes from/to a ring buffer starting at pos, wrapping around
+void ReadRing(const std::vector<uint8_t>& ring, size_t pos, void* dst,
+              size_t size) {
+  size_t first = std::min(size, ring.size() - pos);
+  std::memcpy(dst, ring.data() + pos, first);
+  std::memcpy(static_cast<uint8_t*>(dst) + first, ring.data(), size - first);
+}
+
+void WriteRing(std::vector<uint8_t>& ring, size_t pos, const void* src,
+               size_t size) {
+  size_t first = std::min(size, ring.size() - pos);
+  std::memcpy(ring.data() + pos, src, first);
+  std::memcpy(ring.data(), static_cast<const uint8_t*>(src) + first,
+              size - first);
+}
+
+template <typename T>
+void SplitInt64(uint64_t value, T& dst) {
+  dst.hi = static_cast<unsigned long>(value >> 32);
+  dst.lo = static_cast<unsigned long>(value & 0xFFFFFFFF);
+}
+
+}  // namespace
+
+SimAsioDriver::SimAsioDriver() : SimAsioDriver{Config{}} {}
+
+SimAsioDriver::SimAsioDriver(const Config& config)
+    : Conf{config},
+      RequestedRate{config.SampleRate},
+      SampleRate{config.SampleRate},
+      Random{config.Seed} {}
+
+SimAsioDriver::~SimAsioDriver() { DisposeBuffers(); }
+
+auto SimAsioDriver::GetConfig() const -> const Config& { return Conf; }
+
+long SimAsioDriver::SendMessage(long selector, long value) {
+  if (!Callbacks || !Callbacks->asioMessage) return 0;
+
+  if (selector == kAsioBufferSizeChange) Conf.BufferInfo.PrefSize = value;
+
+  return Callbacks->asioMessage(selector, value, nullptr, nullptr);
+}
+
+ASIOError SimAsioDriver::Init(ASIODriverInfo* info) noexcept {
+  info->driverVersion = 1;
+  std::strncpy(info->name, Name, sizeof(info->name) - 1);
+  std::strncpy(info->errorMessage, "No ASIO Driver Error",
+               sizeof(info->errorMessage) - 1);
+
+  return ASE_OK;
+}
+
+ASIOError SimAsioDriver::Exit() noexcept { return DisposeBuffers(); }
+
+ASIOError SimAsioDriver::Start() noexcept {
+  if (!Callbacks) return ASE_NotPresent;
+  if (Running.load()) return ASE_OK;
+
+  Toggle = 0;
+  SamplePosition = 0;
+  LoopbackPos = 0;
+  for (auto& line : LoopbackLines) std::fill(line.begin(), line.end(), 0);
+
+  Running = true;
+
+  try {
+    Timer = std::thread{&SimAsioDriver::TimerLoop, this};
+  } catch (...) {
+    Running = false;
+    return ASE_HWMalfunction;
+  }
+
+  return ASE_OK;
+}
+
+ASIOError SimAsioDriver::Stop() noexcept {
+  // Can't join itself: stopping from a callback is not allowed
+  if (Timer.get_id() == std::this_thread::get_id()) return ASE_InvalidMode;
+
+  Running = false;
+  if (Timer.joinable()) Timer.join();
+
+  return ASE_OK;
+}
+
+ASIOError SimAsioDriver::GetChannels(long* numInputs,
+                                     long* numOutputs) noexcept {
+  *numInputs = Conf.NumInputs;
+  *numOutputs = Conf.NumOutputs;
+  return ASE_OK;
+}
+
+ASIOError SimAsioDriver::GetLatencies(long* inputLatency,
+                                      long* outputLatency) noexcept {
+  size_t size = BufferSize ? BufferSize : Conf.BufferInfo.PrefSize;
+
+  *inputLatency = size + Conf.ExtraLatency;
+  *outputLatency = size + Conf.ExtraLatency;
+  return ASE_OK;
+}
+
+ASIOError SimAsioDriver::GetBufferSize(long* minSize, long* maxSize,
+                                       long* prefSize,
+                                       long* granularity) noexcept {
+  *minSize = Conf.BufferInfo.MinSize;
+  *maxSize = Conf.BufferInfo.MaxSize;
+  *prefSize = Conf.BufferInfo.PrefSize;
+  *granularity = Conf.BufferInfo.Granularity;
+  return ASE_OK;
+}
+
+ASIOError SimAsioDriver::CanSampleRate(ASIOSampleRate sampleRate) noexcept {
+  for (auto rate : SUPPORTED_RATES)
+    if (rate == sampleRate) return ASE_OK;
+
+  return ASE_NoClock;
+}
+
+ASIOError SimAsioDriver::GetSampleRate(ASIOSampleRate* sampleRate) noexcept {
+  *sampleRate = RequestedRate.load(std::memory_order_relaxed);
+  return ASE_OK;
+}
+
+ASIOError SimAsioDriver::SetSampleRate(ASIOSampleRate sampleRate) noexcept {
+  if (CanSampleRate(sampleRate) != ASE_OK) return ASE_NoClock;
+  // The timer thread owns the clock and the time info, it applies
+  // the rate on its next buffer switch, see ApplySampleRate()
+  if (RequestedRate.exchange(sampleRate, std::memory_order_relaxed) ==
+      sampleRate)
+    return ASE_OK;
+
+  if (Callbacks && Callbacks->sampleRateDidChange)
+    Callbacks->sampleRateDidChange(sampleRate);
+
+  return ASE_OK;
+}
+
+ASIOError SimAsioDriver::GetSamplePosition(ASIOSamples* samplePos,
+                                           ASIOTimeStamp* timeStamp) noexcept {
+  SplitInt64(SamplePosition.load(std::memory_order_acquire), *samplePos);
+  SplitInt64(SystemTime.load(std::memory_order_acquire), *timeStamp);
+  return ASE_OK;
+}
+
+ASIOError SimAsioDriver::GetChannelInfo(ASIOChannelInfo* info) noexcept {
+  size_t available = info->isInput ? Conf.NumInputs : Conf.NumOutputs;
+  if (info->channel < 0 || info->channel >= available)
+    return ASE_InvalidParameter;
+
+  info->isActive = ASIOFalse;
+  for (const auto& channel : Channels)
+    if (channel.IsInput == bool(info->isInput) &&
+        channel.Number == info->channel)
+      info->isActive = ASIOTrue;
+
+  auto name = std::string{info->isInput ? "Sim In " : "Sim Out "} +
+              std::to_string(info->channel);
+
+  info->channelGroup = 0;
+  info->type = Conf.SampleType;
+  std::strncpy(info->name, name.c_str(), sizeof(info->name) - 1);
+
+  return ASE_OK;
+}
+
+ASIOError SimAsioDriver::CreateBuffers(ASIOBufferInfo* bufferInfos,
+                                       long numChannels, long bufferSize,
+                                       ASIOCallbacks* callbacks) noexcept try {
+  DisposeBuffers();
+
+  const auto& binfo = Conf.BufferInfo;
+  bool badSize = bufferSize < binfo.MinSize || bufferSize > binfo.MaxSize ||
+                 bufferSize % binfo.Granularity;
+
+  if (!callbacks || badSize) return ASE_InvalidMode;
+
+  size_t sampleSize = Helpers::GetSampleSize(Conf.SampleType);
+  if (sampleSize == 0) return ASE_InvalidMode;
+
+  for (long i = 0; i < numChannels; ++i) {
+    auto& info = bufferInfos[i];
+    size_t available = info.isInput ? Conf.NumInputs : Conf.NumOutputs;
+
+    if (info.channelNum < 0 || info.channelNum >= available) {
+      DisposeBuffers();
+      return ASE_InvalidParameter;
+    }
+
+    auto& channel = Channels.emplace_back();
+    channel.IsInput = info.isInput;
+    channel.Number = info.channelNum;
+    channel.Storage.assign(2 * bufferSize * sampleSize, 0);
+    channel.Buffers[0] = channel.Storage.data();
+    channel.Buffers[1] = channel.Storage.data() + bufferSize * sampleSize;
+
+    info.buffers[0] = channel.Buffers[0];
+    info.buffers[1] = channel.Buffers[1];
+  }
+
+  // Inputs take active outputs in order, wrapping around
+  std::vector<size_t> outputs;
+  for (size_t i = 0; i < Channels.size(); ++i)
+    if (!Channels[i].IsInput) outputs.push_back(i);
+
+  LoopbackSources.assign(Channels.size(), Channels.size());
+  for (size_t i = 0, nInput = 0; i < Channels.size(); ++i)
+    if (Channels[i].IsInput && !outputs.empty())
+      LoopbackSources[i] = outputs[nInput++ % outputs.size()];
+
+  BufferSize = bufferSize;
+
+  // Output written at position p reaches the inputs at p + delay
+  LoopbackDelay = 2 * (bufferSize + Conf.ExtraLatency);
+  LoopbackPos = 0;
+  LoopbackLines.assign(Channels.size(), {});
+  for (size_t i = 0; i < Channels.size(); ++i)
+    if (Channels[i].IsInput)
+      LoopbackLines[i].assign(LoopbackDelay * sampleSize, 0);
+
+  Scratch.assign(bufferSize, 0);
+  Phases.assign(Channels.size(), 0);
+  Callbacks = callbacks;
+
+  TimeInfoMode =
+      Callbacks->asioMessage &&
+      Callbacks->asioMessage(kAsioSelectorSupported, kAsioSupportsTimeInfo, 0,
+                             0) &&
+      Callbacks->asioMessage(kAsioSupportsTimeInfo, 0, 0, 0);
+
+  // The timer isn't running, the requested rate is taken as it is
+  SampleRate = RequestedRate.load(std::memory_order_relaxed);
+
+  Time = ASIOTime{};
+  Time.timeInfo.speed = 1.;
+  Time.timeInfo.sampleRate = SampleRate;
+  Time.timeInfo.flags =
+      kSystemTimeValid | kSamplePositionValid | kSampleRateValid | kSpeedValid;
+
+  return ASE_OK;
+} catch (const std::bad_alloc&) {
+  DisposeBuffers();
+  return ASE_NoMemory;
+}
+
+ASIOError SimAsioDriver::DisposeBuffers() noexcept {
+  Stop();
+
+  Callbacks = nullptr;
+  BufferSize = 0;
+  Channels.clear();
+
+  return ASE_OK;
+}
+
+ASIOError SimAsioDriver::OutputReady() noexcept {
+  return Conf.SupportsOutputReady ? ASE_OK : ASE_NotPresent;
+}
+
+ASIOError SimAsioDriver::Future(long selector, void* opt) noexcept {
+  switch (selector) {
+    case kAsioCanTimeInfo:
+      return ASE_SUCCESS;
+  }
+
+  return ASE_NotPresent;
+}
+
+std::chrono::nanoseconds SimAsioDriver::GetPeriod() const {
+  using namespace std::chrono;
+
+  auto seconds = duration<double>(BufferSize / SampleRate);
+  return duration_cast<nanoseconds>(seconds);
+}
+
+void SimAsioDriver::TimerLoop() {
+  using Clock = std::chrono::steady_clock;
+
+  std::uniform_int_distribution<int64_t> jitter{0, Conf.Jitter.count()};
+  auto next = Clock::now();
+
+  while (Running.load(std::memory_order_acquire)) {
+    if (Conf.Paced) {
+      next += GetPeriod();
+      auto delay = std::chrono::microseconds{jitter(Random)};
+      std::this_thread::sleep_until(next + delay);
+    }
+
+    BufferSwitch();
+  }
+}
+
+void SimAsioDriver::BufferSwitch() {
+  using namespace std::chrono;
+
+  ApplySampleRate();
+
+  auto now = steady_clock::now().time_since_epoch();
+  SystemTime.store(duration_cast<nanoseconds>(now).count(),
+                   std::memory_order_release);
+
+  if (Conf.Loopback)
+    LoopbackInputs(Toggle);
+  else
+    GenerateInputs(Toggle);
+
+  // Position of the first sample of the block being switched
+  if (TimeInfoMode) {
+    GetSamplePosition(&Time.timeInfo.samplePosition,
+                      &Time.timeInfo.systemTime);
+    Callbacks->bufferSwitchTimeInfo(&Time, Toggle, ASIOFalse);
+    Time.timeInfo.flags &= ~(kSampleRateChanged | kClockSourceChanged);
+  } else {
+    Callbacks->bufferSwitch(Toggle, ASIOFalse);
+  }
+
+  if (Conf.Loopback) LoopbackOutputs(Toggle);
+
+  SamplePosition.fetch_add(BufferSize, std::memory_order_acq_rel);
+  Toggle = Toggle ? 0 : 1;
+}
+
+void SimAsioDriver::ApplySampleRate() {
+  ASIOSampleRate requested = RequestedRate.load(std::memory_order_relaxed);
+  if (requested == SampleRate) return;
+
+  SampleRate = requested;
+  Time.timeInfo.sampleRate = requested;
+  Time.timeInfo.flags |= kSampleRateChanged;
+}
+
+void SimAsioDriver::GenerateInputs(long index) {
+  auto converter = Helpers::GetSampleConverter(Conf.SampleType);
+  size_t sampleSize = Helpers::GetSampleSize(Conf.SampleType);
+
+  for (size_t i = 0; i < Channels.size(); ++i) {
+    const auto& channel = Channels[i];
+    if (!channel.IsInput) continue;
+
+    if (!converter) {
+      std::memset(channel.Buffers[index], 0, BufferSize * sampleSize);
+      continue;
+    }
+
+    double freq = TONE_BASE_FREQ * (channel.Number + 1);
+    double step = 2 * std::numbers::pi * freq / SampleRate;
+    double& phase = Phases[i];
+
+    for (size_t s = 0; s < BufferSize; ++s) {
+      Scratch[s] = TONE_AMPLITUDE * std::sin(phase);
+      phase = std::fmod(phase + step, 2 * std::numbers::pi);
+    }
+
+    converter->FromFloat(Scratch.data(), channel.Buffers[index], BufferSize);
+  }
+}
+
+void SimAsioDriver::LoopbackInputs(long index) {
+  size_t sampleSize = Helpers::GetSampleSize(Conf.SampleType);
+  size_t bytes = BufferSize * sampleSize;
+
+  // Delay is at least one buffer, so everything read here
+  // was written by the previous switches
+  for (size_t i = 0; i < Channels.size(); ++i) {
+    auto& channel = Channels[i];
+    if (!channel.IsInput) continue;
+
+    if (LoopbackSources[i] == Channels.size())
+      std::memset(channel.Buffers[index], 0, bytes);
+    else
+      ReadRing(LoopbackLines[i], LoopbackPos * sampleSize,
+               channel.Buffers[index], bytes);
+  }
+}
+
+void SimAsioDriver::LoopbackOutputs(long index) {
+  size_t sampleSize = Helpers::GetSampleSize(Conf.SampleType);
+  size_t bytes = BufferSize * sampleSize;
+
+  for (size_t i = 0; i < Channels.size(); ++i) {
+    if (!Channels[i].IsInput || LoopbackSources[i] == Channels.size())
+      continue;
+
+    const auto& output = Channels[LoopbackSources[i]];
+    WriteRing(LoopbackLines[i], LoopbackPos * sampleSize,
+              output.Buffers[index], bytes);
+  }
+
+  LoopbackPos = (LoopbackPos + BufferSize) % LoopbackDelay;
+}
+
+}  // namespace GigOn
@@ -0,0 +1,35 @@
+#include "TscClock.hpp"
+
+#include <thread>
+
+namespace GigOn {
+namespace Helpers {
+
+namespace {
+
+const std::chrono::milliseconds CALIBRATION_PERIOD{20};
+
+double Calibrate() {
+  using Clock = std::chrono::steady_clock;
+
+  auto begin = Clock::now();
+  uint64_t beginTicks = TscClock::Now();
+
+  std::this_thread::sleep_for(CALIBRATION_PERIOD);
+
+  auto end = Clock::now();
+  uint64_t endTicks = TscClock::Now();
+
+  auto elapsed = std::chrono::duration<double, std::nano>(end - begin);
+  return (endTicks - beginTicks) / elapsed.count();
+}
+
+}  // namespace
+
+double TscClock::GetTicksPerNs() {
+  static const double ticksPerNs = Calibrate();
+  return ticksPerNs;
+}
+
+}  // namespace Helpers
+}  // namespace GigOn
@@ -1,5 +1,7 @@
 #include "Vst2Effect.hpp"
 
+#include <algorithm>
+
 /*** Some compile-time checks ***/
 
 // NOLINTBEGIN
@@ -24,32 +26,6 @@ ASSERT_SIZE(VstIntPtr, sizeof(void*));
 
 namespace GigOn {
 
-VstProcessBuffer::VstProcessBuffer(size_t blockSize, size_t nChannels)
-    : BlockSize{blockSize}, NChannels{nChannels} {
-  Buffer = std::vector<float>(nChannels * blockSize, 0);
-  Pointers = std::vector<float*>(nChannels, 0);
-
-  for (int i = 0; i < nChannels; ++i) Pointers[i] = &Buffer[blockSize * i];
-}
-
-auto VstProcessBuffer::GetVstBuffers() -> VstBufferT { return Pointers.data(); }
-auto VstProcessBuffer::GetVstBuffers() const -> CVstBufferT {
-  return Pointers.data();
-}
-
-float* VstProcessBuffer::GetBufferByChannel(size_t channel) {
-  assert(channel < NChannels.Access());
-  return Pointers[channel];
-}
-
-const float* VstProcessBuffer::GetBufferByChannel(size_t channel) const {
-  assert(channel < NChannels.Access());
-  return Pointers[channel];
-}
-
-size_t VstProcessBuffer::GetBlockSize() const { return BlockSize.Access(); }
-size_t VstProcessBuffer::GetChannels() const { return NChannels.Access(); }
-
 Vst2Effect::Vst2Effect(const Helpers::DllLoader& dll) {
   FARPROC proc = dll.GetProcAddress(MainEntryName);
   auto entry = reinterpret_cast<PluginEntryProc>(proc);
@@ -61,18 +37,25 @@ Vst2Effect::Vst2Effect(const Helpers::DllLoader& dll) {
         Label, "Failed to load plugin from " + dll.GetPath());
 
   Effect = {newEffect, {}};
+  Events = std::make_unique<VstEventQueue>();
+  ProcessErrors = std::make_unique<std::atomic<uint32_t>>(0);
   OpenImpl();
   FetchInfo();
 }
 
-void Vst2Effect::Configure(float sampleRate, VstInt32 blockSize) {
+void Vst2Effect::Configure(float sampleRate, VstInt32 blockSize,
+                           Precision precision) {
   if (Started.Access())
     throw Helpers::LabelException(Label, "Can't configure: now running");
 
+  if (!Info.CanProcessDouble) precision = Precision::Single;
+
   SetSampleRateImpl(sampleRate);
   SetBlockSizeImpl(blockSize);
+  SetPrecisionImpl(precision);
 
   BlockSize = blockSize;
+  ProcessPrecision = precision;
   Configured.Access() = true;
 }
 
@@ -94,31 +77,106 @@ void Vst2Effect::Stop() {
   Started.Access() = false;
 }
 
+template <typename T>
+bool Vst2Effect::CheckBuffers(const BasicVstProcessView<T>& input,
+                              const BasicVstProcessView<T>& output,
+                              Precision precision) noexcept {
+  bool ok = true;
+
+  auto expect = [&](bool cond, ProcessError error) {
+    if (!cond) RaiseProcessError(error);
+    ok = ok && cond;
+  };
+
+  expect(Started.Access(), ProcessError::NotRunning);
+  expect(precision == ProcessPrecision, ProcessError::PrecisionMismatch);
+  expect(input.GetBlockSize() <= BlockSize &&
+             input.GetChannels() == size_t(Effect->numInputs),
+         ProcessError::BadInputs);
+  expect(output.GetBlockSize() == input.GetBlockSize() &&
+             output.GetChannels() == size_t(Effect->numOutputs),
+         ProcessError::BadOutputs);
+
+  if (!ok)
+    for (size_t ch = 0; ch < output.GetChannels(); ++ch)
+      std::fill_n(output.GetBufferByChannel(ch), output.GetBlockSize(), T{});
+
+  return ok;
+}
+
+// For some reason an API accepts non-const pointer to input buffer
+// So we have to cast it here
 void Vst2Effect::Process(const VstProcessBuffer& input,
-                         VstProcessBuffer& output) {
-  if (!Started.Access())
-    throw Helpers::LabelException(Label, "Can't process: not running");
+                         VstProcessBuffer& output) noexcept {
+  Process(VstProcessView{const_cast<VstProcessBuffer&>(input)},
+          VstProcessView{output});
+}
 
-  if (input.GetBlockSize() != BlockSize ||
-      input.GetChannels() != Effect->numInputs)
-    throw Helpers::LabelException(Label,
-                                  "Can't process: incorrect input buffers");
+void Vst2Effect::Process(const VstProcessDoubleBuffer& input,
+                         VstProcessDoubleBuffer& output) noexcept {
+  Process(VstProcessDoubleView{const_cast<VstProcessDoubleBuffer&>(input)},
+          VstProcessDoubleView{output});
+}
 
-  if (output.GetBlockSize() != BlockSize ||
-      output.GetChannels() != Effect->numOutputs)
-    throw Helpers::LabelException(Label,
-                                  "Can't process: incorrect output buffers");
+// Views are shallow, the pointer arrays belong to the caller
+void Vst2Effect::Process(const VstProcessView& input,
+                         const VstProcessView& output) noexcept {
+  if (!CheckBuffers(input, output, Precision::Single)) return;
+
+  VstInt32 frames = VstInt32(input.GetBlockSize());
+  ProcessEventsImpl(frames);
 
-  // For some reason an API accepts non-const pointer to input buffer
-  // So we have to cast it here
   float** inputBuf = const_cast<float**>(input.GetVstBuffers());
-  float** outputBuf = output.GetVstBuffers();
+  float** outputBuf = const_cast<float**>(output.GetVstBuffers());
 
-  Effect->processReplacing(Effect.get(), inputBuf, outputBuf, BlockSize);
+  Effect->processReplacing(Effect.get(), inputBuf, outputBuf, frames);
+}
+
+void Vst2Effect::Process(const VstProcessDoubleView& input,
+                         const VstProcessDoubleView& output) noexcept {
+  if (!CheckBuffers(input, output, Precision::Double)) return;
+
+  VstInt32 frames = VstInt32(input.GetBlockSize());
+  ProcessEventsImpl(frames);
+
+  double** inputBuf = const_cast<double**>(input.GetVstBuffers());
+  double** outputBuf = const_cast<double**>(output.GetVstBuffers());
+
+  Effect->processDoubleReplacing(Effect.get(), inputBuf, outputBuf, frames);
+}
+
+uint32_t Vst2Effect::TakeProcessErrors() noexcept {
+  return ProcessErrors->exchange(0, std::memory_order_acq_rel);
+}
+
+bool Vst2Effect::HasProcessError(uint32_t errors, ProcessError error) {
+  return errors & static_cast<uint32_t>(error);
+}
+
+void Vst2Effect::RaiseProcessError(ProcessError error) noexcept {
+  ProcessErrors->fetch_or(static_cast<uint32_t>(error),
+                          std::memory_order_release);
+}
+
+bool Vst2Effect::SendMidi(const MidiEvent& event) noexcept {
+  return Events->Push(event);
+}
+
+int64_t Vst2Effect::GetSamplePosition() const noexcept {
+  return Events->GetPosition();
 }
 
 auto Vst2Effect::GetInfo() const -> EffectInfo { return Info; }
 
+auto Vst2Effect::GetPrecision() const -> Precision { return ProcessPrecision; }
+
+size_t Vst2Effect::GetBlockSize() const { return BlockSize; }
+
+size_t Vst2Effect::GetInitialDelay() const {
+  assert(Effect);
+  return Effect->initialDelay > 0 ? Effect->initialDelay : 0;
+}
+
 auto Vst2Effect::Dispatcher(VstInt32 opCode, VstInt32 index, VstIntPtr value,
                             void* ptr, float opt) -> VstIntPtr {
   assert(Effect);
@@ -143,6 +201,21 @@ void Vst2Effect::SetBlockSizeImpl(VstInt32 size) {
   Dispatcher(effSetBlockSize, 0, size, 0, 0);
 }
 
+// The answer is ignored: AudioEffectX answers 0 unless the plugin
+// overrides setProcessPrecision(), even with processDoubleReplacing()
+// implemented. effFlagsCanDoubleReplacing is what counts
+void Vst2Effect::SetPrecisionImpl(Precision precision) {
+  VstIntPtr value = precision == Precision::Double ? kVstProcessPrecision64
+                                                   : kVstProcessPrecision32;
+  Dispatcher(effSetProcessPrecision, 0, value, 0, 0);
+}
+
+// Also called with no events: the position has to advance either way
+void Vst2Effect::ProcessEventsImpl(VstInt32 frames) noexcept {
+  VstEvents* events = Events->Collect(frames);
+  if (events->numEvents > 0) Dispatcher(effProcessEvents, 0, 0, events, 0);
+}
+
 void Vst2Effect::StartImpl() { Dispatcher(effMainsChanged, 0, 1, 0, 0); }
 void Vst2Effect::StopImpl() { Dispatcher(effMainsChanged, 0, 0, 0, 0); }
 
@@ -158,6 +231,8 @@ void Vst2Effect::FetchInfo() {
 
   Info.NumInputs = Effect->numInputs;
   Info.NumOutputs = Effect->numOutputs;
+  Info.CanProcessDouble = Effect->flags & effFlagsCanDoubleReplacing;
+  Info.IsSynth = Effect->flags & effFlagsIsSynth;
 }
 
 // Audiomaster callback that handles plugin queries
@@ -175,6 +250,10 @@ VstIntPtr VSTCALLBACK Vst2Effect::AMCallback(AEffect* effect, VstInt32 opCode,
     case audioMasterVersion:
       result = kVstVersion;
       break;
+    case audioMasterIOChanged:
+      // Initial delay is read live by GetInitialDelay()
+      result = 1;
+      break;
   }
 
   return result;
@@ -0,0 +1,63 @@
+#include "VstEventQueue.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace GigOn {
+
+VstEventQueue::VstEventQueue() {
+  Events.Header.numEvents = 0;
+  Events.Header.reserved = 0;
+}
+
+bool VstEventQueue::Push(const MidiEvent& event) noexcept {
+  return Incoming.Push(event);
+}
+
+VstEvents* VstEventQueue::Collect(size_t frames) noexcept {
+  const int64_t begin = Position.load(std::memory_order_relaxed);
+  const int64_t end = begin + int64_t(frames);
+
+  MidiEvent event;
+  while (NPending < Capacity && Incoming.Pop(event))
+    Pending[NPending++] = event;
+
+  VstEvent** list = Events.Header.events;
+  size_t count = 0;
+  size_t kept = 0;
+
+  for (size_t i = 0; i < NPending; ++i) {
+    const MidiEvent& pending = Pending[i];
+
+    if (pending.Position >= end) {
+      Pending[kept++] = pending;
+      continue;
+    }
+
+    VstMidiEvent& midi = MidiEvents[count];
+    midi = {};
+    midi.type = kVstMidiType;
+    midi.byteSize = sizeof(VstMidiEvent);
+    midi.deltaFrames = VstInt32(std::max<int64_t>(pending.Position - begin, 0));
+    std::memcpy(midi.midiData, pending.Data, sizeof(pending.Data));
+
+    // Producers race each other, so keep the list sorted. Stable, as
+    // events of the same frame have to stay in the order they came in
+    size_t j = count++;
+    for (; j > 0 && list[j - 1]->deltaFrames > midi.deltaFrames; --j)
+      list[j] = list[j - 1];
+    list[j] = reinterpret_cast<VstEvent*>(&midi);
+  }
+
+  NPending = kept;
+  Events.Header.numEvents = VstInt32(count);
+  Position.store(end, std::memory_order_relaxed);
+
+  return &Events.Header;
+}
+
+int64_t VstEventQueue::GetPosition() const noexcept {
+  return Position.load(std::memory_order_relaxed);
+}
+
+}  // namespace GigOn
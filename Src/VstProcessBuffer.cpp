@@ -0,0 +1,130 @@
+#include "VstProcessBuffer.hpp"
+
+#include <cassert>
+#include <utility>
+
+namespace GigOn {
+
+namespace {
+
+size_t RoundUp(size_t value, size_t step) {
+  return (value + step - 1) / step * step;
+}
+
+template <typename T>
+size_t ComputeStride(size_t blockSize, size_t padding) {
+  constexpr size_t alignment = BasicVstProcessBuffer<T>::Alignment;
+  static_assert(alignment % sizeof(T) == 0);
+
+  size_t bytes = RoundUp(blockSize * sizeof(T), alignment);
+  return (bytes + RoundUp(padding, alignment)) / sizeof(T);
+}
+
+}  // namespace
+
+template <typename T>
+BasicVstProcessBuffer<T>::BasicVstProcessBuffer(size_t blockSize,
+                                                size_t nChannels,
+                                                size_t padding)
+    : BlockSize{blockSize},
+      NChannels{nChannels},
+      Stride{ComputeStride<T>(blockSize, padding)} {
+  Buffer = Helpers::AlignedVector<T, Alignment>(nChannels * Stride, 0);
+  Storage = Buffer.data();
+  Pointers = std::vector<T*>(nChannels, nullptr);
+
+  for (size_t i = 0; i < nChannels; ++i) Pointers[i] = Storage + Stride * i;
+}
+
+template <typename T>
+BasicVstProcessBuffer<T>::BasicVstProcessBuffer(BufferArena& arena,
+                                                size_t blockSize,
+                                                size_t nChannels,
+                                                size_t padding)
+    : BlockSize{blockSize},
+      NChannels{nChannels},
+      Stride{ComputeStride<T>(blockSize, padding)} {
+  if (nChannels > 0) Storage = arena.Allocate<T>(nChannels * Stride);
+  Pointers = std::vector<T*>(nChannels, nullptr);
+
+  for (size_t i = 0; i < nChannels; ++i) Pointers[i] = Storage + Stride * i;
+}
+
+template <typename T>
+BasicVstProcessBuffer<T>::BasicVstProcessBuffer(
+    BasicVstProcessBuffer&& other) noexcept
+    : BlockSize{std::exchange(other.BlockSize, 0)},
+      NChannels{std::exchange(other.NChannels, 0)},
+      Stride{std::exchange(other.Stride, 0)},
+      Buffer{std::move(other.Buffer)},
+      Storage{std::exchange(other.Storage, nullptr)},
+      Pointers{std::move(other.Pointers)} {}
+
+template <typename T>
+auto BasicVstProcessBuffer<T>::operator=(BasicVstProcessBuffer&& other) noexcept
+    -> BasicVstProcessBuffer& {
+  // Moving a vector keeps its storage, Storage and the pointers
+  // stay valid
+  BlockSize = std::exchange(other.BlockSize, 0);
+  NChannels = std::exchange(other.NChannels, 0);
+  Stride = std::exchange(other.Stride, 0);
+  Buffer = std::move(other.Buffer);
+  Storage = std::exchange(other.Storage, nullptr);
+  Pointers = std::move(other.Pointers);
+  return *this;
+}
+
+template <typename T>
+auto BasicVstProcessBuffer<T>::GetVstBuffers() -> VstBufferT {
+  return Pointers.data();
+}
+
+template <typename T>
+auto BasicVstProcessBuffer<T>::GetVstBuffers() const -> CVstBufferT {
+  return Pointers.data();
+}
+
+template <typename T>
+T* BasicVstProcessBuffer<T>::GetBufferByChannel(size_t channel) {
+  assert(channel < NChannels);
+  return Pointers[channel];
+}
+
+template <typename T>
+const T* BasicVstProcessBuffer<T>::GetBufferByChannel(size_t channel) const {
+  assert(channel < NChannels);
+  return Pointers[channel];
+}
+
+template <typename T>
+void BasicVstProcessBuffer<T>::SetBufferByChannel(size_t channel, T* buffer) {
+  assert(channel < NChannels);
+  assert(buffer);
+  Pointers[channel] = buffer;
+}
+
+template <typename T>
+void BasicVstProcessBuffer<T>::ResetBufferByChannel(size_t channel) {
+  assert(channel < NChannels);
+  Pointers[channel] = Storage + Stride * channel;
+}
+
+template <typename T>
+size_t BasicVstProcessBuffer<T>::GetBlockSize() const {
+  return BlockSize;
+}
+
+template <typename T>
+size_t BasicVstProcessBuffer<T>::GetChannels() const {
+  return NChannels;
+}
+
+template <typename T>
+size_t BasicVstProcessBuffer<T>::GetStride() const {
+  return Stride;
+}
+
+template class BasicVstProcessBuffer<float>;
+template class BasicVstProcessBuffer<double>;
+
+}  // namespace GigOn
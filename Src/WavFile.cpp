@@ -0,0 +1,227 @@
+#include "WavFile.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+// WAV is little-endian, samples are copied as is
+static_assert(std::endian::native == std::endian::little,
+              "WAV I/O supports little-endian hosts only");
+
+namespace GigOn {
+
+namespace {
+
+const uint16_t WAVE_FORMAT_PCM = 1;
+const uint16_t WAVE_FORMAT_IEEE_FLOAT = 3;
+const uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+const size_t FMT_CHUNK_SIZE = 16;
+const size_t HEADER_SIZE = 44;
+
+template <typename T>
+T Load(const uint8_t* src) {
+  T value;
+  std::memcpy(&value, src, sizeof(T));
+  return value;
+}
+
+template <typename T>
+void Store(std::ofstream& file, T value) {
+  file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+float LoadPcm(const uint8_t* src, size_t bits) {
+  switch (bits) {
+    case 16:
+      return Load<int16_t>(src) / 32768.f;
+    case 24: {
+      // Sign-extend by placing 3 bytes at the top of int32
+      int32_t val = (src[0] << 8) | (src[1] << 16) | (src[2] << 24);
+      return (val >> 8) / 8388608.f;
+    }
+    case 32:
+      return Load<int32_t>(src) / 2147483648.f;
+  }
+
+  return 0;
+}
+
+float LoadFloat(const uint8_t* src, size_t bits) {
+  return bits == 64 ? float(Load<double>(src)) : Load<float>(src);
+}
+
+}  // namespace
+
+/*** WavReader ***/
+
+WavReader::WavReader(const std::string& path)
+    : File{path, std::ios::binary}, Path{path} {
+  if (!File) Fail("can't open file");
+  ParseHeader();
+}
+
+void WavReader::ParseHeader() {
+  uint8_t riff[12];
+  if (!File.read(reinterpret_cast<char*>(riff), sizeof(riff)) ||
+      std::memcmp(riff, "RIFF", 4) || std::memcmp(riff + 8, "WAVE", 4))
+    Fail("not a RIFF/WAVE file");
+
+  bool fmtFound = false;
+
+  while (true) {
+    uint8_t chunk[8];
+    if (!File.read(reinterpret_cast<char*>(chunk), sizeof(chunk)))
+      Fail("no data chunk");
+
+    uint32_t size = Load<uint32_t>(chunk + 4);
+
+    if (!std::memcmp(chunk, "fmt ", 4)) {
+      std::vector<uint8_t> fmt(size);
+      if (size < FMT_CHUNK_SIZE ||
+          !File.read(reinterpret_cast<char*>(fmt.data()), size))
+        Fail("broken fmt chunk");
+
+      uint16_t tag = Load<uint16_t>(&fmt[0]);
+      NumChannels = Load<uint16_t>(&fmt[2]);
+      SampleRate = Load<uint32_t>(&fmt[4]);
+      BitsPerSample = Load<uint16_t>(&fmt[14]);
+
+      // Extensible format keeps the actual tag
+      // in the first two bytes of the subformat GUID
+      if (tag == WAVE_FORMAT_EXTENSIBLE && size >= 26)
+        tag = Load<uint16_t>(&fmt[24]);
+
+      if (tag == WAVE_FORMAT_PCM &&
+          (BitsPerSample == 16 || BitsPerSample == 24 || BitsPerSample == 32))
+        SampleFormat = Format::Pcm;
+      else if (tag == WAVE_FORMAT_IEEE_FLOAT &&
+               (BitsPerSample == 32 || BitsPerSample == 64))
+        SampleFormat = Format::Float;
+      else
+        Fail("unsupported sample format");
+
+      if (NumChannels == 0) Fail("no channels");
+      fmtFound = true;
+    } else if (!std::memcmp(chunk, "data", 4)) {
+      if (!fmtFound) Fail("data chunk before fmt chunk");
+
+      NumFrames = size / (NumChannels * BitsPerSample / 8);
+      FramesLeft = NumFrames;
+      return;
+    } else {
+      // Chunks are padded to even size
+      File.seekg(size + (size & 1), std::ios::cur);
+    }
+  }
+}
+
+size_t WavReader::Read(float* dst, size_t nFrames) {
+  size_t frames = std::min(nFrames, FramesLeft);
+  size_t sampleBytes = BitsPerSample / 8;
+  size_t nSamples = frames * NumChannels;
+
+  Raw.resize(nSamples * sampleBytes);
+
+  if (!File.read(reinterpret_cast<char*>(Raw.data()), Raw.size()))
+    Fail("unexpected end of file");
+
+  const uint8_t* src = Raw.data();
+
+  if (SampleFormat == Format::Pcm)
+    for (size_t i = 0; i < nSamples; ++i, src += sampleBytes)
+      dst[i] = LoadPcm(src, BitsPerSample);
+  else
+    for (size_t i = 0; i < nSamples; ++i, src += sampleBytes)
+      dst[i] = LoadFloat(src, BitsPerSample);
+
+  FramesLeft -= frames;
+  return frames;
+}
+
+size_t WavReader::GetChannels() const { return NumChannels; }
+size_t WavReader::GetSampleRate() const { return SampleRate; }
+size_t WavReader::GetFrames() const { return NumFrames; }
+
+void WavReader::Fail(const std::string& msg) const {
+  throw std::runtime_error(std::string{Label} + ": " + Path + ": " + msg);
+}
+
+/*** WavWriter ***/
+
+WavWriter::WavWriter(const std::string& path, size_t nChannels,
+                     size_t sampleRate)
+    : File{path, std::ios::binary | std::ios::trunc},
+      Path{path},
+      NumChannels{nChannels} {
+  if (!File) Fail("can't open file");
+  if (nChannels == 0) Fail("no channels");
+
+  WriteHeader(sampleRate);
+}
+
+WavWriter::~WavWriter() {
+  if (!File.is_open()) return;
+
+  try {
+    Close();
+  } catch (...) {
+  }
+}
+
+void WavWriter::WriteHeader(size_t sampleRate) {
+  uint16_t blockAlign = NumChannels * sizeof(float);
+
+  File.write("RIFF", 4);
+  Store<uint32_t>(File, 0);  // Patched in Close()
+  File.write("WAVE", 4);
+
+  File.write("fmt ", 4);
+  Store<uint32_t>(File, FMT_CHUNK_SIZE);
+  Store<uint16_t>(File, WAVE_FORMAT_IEEE_FLOAT);
+  Store<uint16_t>(File, NumChannels);
+  Store<uint32_t>(File, sampleRate);
+  Store<uint32_t>(File, sampleRate * blockAlign);
+  Store<uint16_t>(File, blockAlign);
+  Store<uint16_t>(File, 8 * sizeof(float));
+
+  File.write("data", 4);
+  Store<uint32_t>(File, 0);  // Patched in Close()
+
+  if (!File) Fail("can't write header");
+}
+
+void WavWriter::Write(const float* src, size_t nFrames) {
+  File.write(reinterpret_cast<const char*>(src),
+             nFrames * NumChannels * sizeof(float));
+  if (!File) Fail("can't write samples");
+
+  NumFrames += nFrames;
+}
+
+void WavWriter::Close() {
+  if (!File.is_open()) return;
+
+  size_t dataSize = NumFrames * NumChannels * sizeof(float);
+  if (dataSize + HEADER_SIZE - 8 > std::numeric_limits<uint32_t>::max())
+    Fail("file is too large for WAV");
+
+  File.seekp(4);
+  Store<uint32_t>(File, dataSize + HEADER_SIZE - 8);
+  File.seekp(HEADER_SIZE - 4);
+  Store<uint32_t>(File, dataSize);
+
+  File.close();
+  if (!File) Fail("can't finalize file");
+}
+
+size_t WavWriter::GetChannels() const { return NumChannels; }
+size_t WavWriter::GetFrames() const { return NumFrames; }
+
+void WavWriter::Fail(const std::string& msg) const {
+  throw std::runtime_error(std::string{Label} + ": " + Path + ": " + msg);
+}
+
+}  // namespace GigOn
@@ -0,0 +1,56 @@
+#include "XrunMonitor.hpp"
+
+namespace GigOn {
+namespace Helpers {
+
+/*** XrunMonitor ***/
+
+void XrunMonitor::Configure(size_t bufferSize, double sampleRate) {
+  double periodNs = bufferSize * 1e9 / sampleRate;
+  double periodTicks = periodNs * TscClock::GetTicksPerNs();
+
+  PeriodNs.store(periodNs, std::memory_order_relaxed);
+  PeriodTicks.store(uint64_t(periodTicks), std::memory_order_relaxed);
+  LoadPerTick.store(periodTicks > 0 ? LoadScale / periodTicks : 0,
+                    std::memory_order_relaxed);
+}
+
+auto XrunMonitor::TakeSnapshot() const -> Snapshot {
+  Snapshot snapshot;
+
+  snapshot.Load = Histogram.TakeSnapshot();
+  snapshot.Switches = snapshot.Load.TotalCount;
+  snapshot.Misses = Misses.load(std::memory_order_relaxed);
+  snapshot.Overloads = Overloads.load(std::memory_order_relaxed);
+  snapshot.PeriodNs = PeriodNs.load(std::memory_order_relaxed);
+
+  return snapshot;
+}
+
+/*** XrunMonitor::Snapshot ***/
+
+double XrunMonitor::Snapshot::GetLoadAtPercentile(double percentile) const {
+  return double(Load.GetValueAtPercentile(percentile)) / LoadScale;
+}
+
+double XrunMonitor::Snapshot::GetMaxLoad() const {
+  return double(Load.GetMax()) / LoadScale;
+}
+
+double XrunMonitor::Snapshot::GetMeanLoad() const {
+  return Load.GetMean() / LoadScale;
+}
+
+auto XrunMonitor::Snapshot::Since(const Snapshot& earlier) const -> Snapshot {
+  Snapshot delta = *this;
+
+  delta.Load = Load.Since(earlier.Load);
+  delta.Switches = delta.Load.TotalCount;
+  delta.Misses -= earlier.Misses;
+  delta.Overloads -= earlier.Overloads;
+
+  return delta;
+}
+
+}  // namespace Helpers
+}  // namespace GigOn